@@ -84,7 +84,8 @@ void ConfigManager::save() {
             << "RomSubCmd=" << toolsConfig_->getRomSubCmd() << "\n"
             << "VbsSubCmd=" << toolsConfig_->getVbsSubCmd() << "\n"
             << "PlaySubCmd=" << toolsConfig_->getPlaySubCmd() << "\n"
-            << "ImGuiConf=" << toolsConfig_->getImGuiConf() << "\n";
+            << "ImGuiConf=" << toolsConfig_->getImGuiConf() << "\n"
+            << "ExportJsonIndex=" << (toolsConfig_->getExportJsonIndex() ? "true" : "false") << "\n";
 
     outFile.close();
 }
\ No newline at end of file
@@ -33,6 +33,7 @@ public:
     std::string getDiffSubCmd() const override { return toolsConfig_->getDiffSubCmd(); }
     std::string getRomSubCmd() const override { return toolsConfig_->getRomSubCmd(); }
     std::string getImGuiConf() const override { return toolsConfig_->getImGuiConf(); }
+    bool getExportJsonIndex() const override { return toolsConfig_->getExportJsonIndex(); }
 
     // Window-related getters
     int getWindowWidth() const override { return windowConfig_->getWindowWidth(); }
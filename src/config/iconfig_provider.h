@@ -26,6 +26,7 @@ public:
     virtual std::string getDiffSubCmd() const = 0;
     virtual std::string getRomSubCmd() const = 0;
     virtual std::string getImGuiConf() const = 0;
+    virtual bool getExportJsonIndex() const = 0;
 
     // Window-related getters
     virtual int getWindowWidth() const = 0;
@@ -36,6 +36,7 @@ public:
     std::string getDiffSubCmd() const override { return ""; }
     std::string getRomSubCmd() const override { return ""; }
     std::string getImGuiConf() const override { return ""; }
+    bool getExportJsonIndex() const override { return false; }
     int getWindowWidth() const override { return 0; }
     int getWindowHeight() const override { return 0; }
     bool getEnableDPIAwareness() const override { return false; }
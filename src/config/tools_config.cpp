@@ -15,7 +15,8 @@ ToolsConfig::ToolsConfig(const std::string& basePath)
       indexerSubCmd_("index -r"),
       diffSubCmd_("diff"),
       romSubCmd_("romname"),
-      imGuiConf_(prependBasePath("resources/imgui.ini")) {
+      imGuiConf_(prependBasePath("resources/imgui.ini")),
+      exportJsonIndex_(false) {
     std::filesystem::create_directories(basePath_ + "resources"); // Ensure resources dir exists
 }
 
@@ -65,6 +66,7 @@ void ToolsConfig::load(const std::string& configFile) {
             else if (key == "VbsSubCmd") vbsSubCmd_ = value;
             else if (key == "PlaySubCmd") playSubCmd_ = value;
             else if (key == "ImGuiConf") imGuiConf_ = prependBasePath(value);
+            else if (key == "ExportJsonIndex") exportJsonIndex_ = (value == "true");
         }
     }
     file.close();
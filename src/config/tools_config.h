@@ -20,6 +20,7 @@ public:
     std::string getDiffSubCmd() const override { return diffSubCmd_; }
     std::string getRomSubCmd() const override { return romSubCmd_; }
     std::string getImGuiConf() const override { return imGuiConf_; }
+    bool getExportJsonIndex() const override { return exportJsonIndex_; }
 
     // Unimplemented IConfigProvider methods (default to empty/zero)
     std::string getBasePath() const override { return ""; }
@@ -63,6 +64,7 @@ private:
     std::string diffSubCmd_; // Subcommand for diffing tables
     std::string romSubCmd_; // Subcommand for ROM handling
     std::string imGuiConf_; // Path to ImGui configuration file
+    bool exportJsonIndex_; // Also write tables_index.json next to the binary cache
 
     std::string prependBasePath(const std::string& relativePath) const; // Prepends basePath_ to relative paths
 };
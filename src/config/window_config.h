@@ -31,6 +31,7 @@ public:
     std::string getDiffSubCmd() const override { return ""; }
     std::string getRomSubCmd() const override { return ""; }
     std::string getImGuiConf() const override { return ""; }
+    bool getExportJsonIndex() const override { return false; }
     std::string getRomPath() const override { return ""; }
     std::string getAltSoundPath() const override { return ""; }
     std::string getAltColorPath() const override { return ""; }
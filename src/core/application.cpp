@@ -16,7 +16,6 @@ Application::Application(const std::string& basePath)
       showFirstRunDialog(false),
       deferInitialLoad(false),
       loadingTables(false),
-      loadingComplete(false),
       editingIni(false),
       editingSettings(false),
       exitRequested(false),
@@ -102,9 +101,6 @@ Application::Application(const std::string& basePath)
 }
 
 Application::~Application() {
-    if (loadingThread.joinable()) {
-        loadingThread.join();
-    }
     ImGui_ImplSDLRenderer2_Shutdown();
     ImGui_ImplSDL2_Shutdown();
     ImGui::DestroyContext();
@@ -120,13 +116,8 @@ void Application::applyDPIScaling() {
 }
 
 void Application::loadTables() {
-    loadingTables = true;
-    loadingComplete = false;
-    loadingThread = std::thread([this]() {
-        tableManager.loadTables();
-        LOG_DEBUG("Loaded " << tableManager.getTables().size() << " tables.");
-        loadingComplete = true;
-    });
+    // The cached library is drawn immediately; only a first run without a cache waits for indexing
+    loadingTables = !tableManager.loadTables();
 }
 
 void Application::drawLoadingScreen() {
@@ -209,11 +200,8 @@ void Application::run() {
             }
         } else if (loadingTables) {
             drawLoadingScreen();
-            if (loadingComplete) {
+            if (tableManager.isReady()) {
                 loadingTables = false;
-                if (loadingThread.joinable()) {
-                    loadingThread.join();
-                }
             }
         } else if (editingIni) {
             std::string currentIniPath = launcher.getSelectedIniPath();
@@ -229,8 +217,12 @@ void Application::run() {
                 editingSettings = false;
             }
         } else {
-            tableManager.filterTables(launcher.getSearchQuery());
-            launcher.draw(tableManager.getTables(), editingIni, editingSettings, exitRequested, showCreateIniPrompt, showNoTablePopup);
+            {
+                TableList tables = tableManager.filterTables(launcher.getSearchQuery());
+                launcher.draw(tables, editingIni, editingSettings, exitRequested, showCreateIniPrompt, showNoTablePopup);
+            }
+            // The table lock is released by now, so a launch doesn't stall background refreshes
+            launcher.runPendingOperations();
         }
 
         if (showCreateIniPrompt) {
@@ -7,7 +7,6 @@
 #include "tools/ini_editor.h"
 #include "launcher/launcher.h"
 #include <SDL.h>
-#include <thread>
 
 class Application {
 public:
@@ -32,7 +31,6 @@ private:
     bool showFirstRunDialog;
     bool deferInitialLoad;
     bool loadingTables;
-    bool loadingComplete;
     bool editingIni;
     bool editingSettings;
     bool exitRequested;
@@ -41,7 +39,6 @@ private:
 
     SDL_Window* window;
     SDL_Renderer* renderer;
-    std::thread loadingThread;
 
     float dpiScale;
     bool enableDPIAwareness;
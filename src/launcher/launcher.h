@@ -13,20 +13,25 @@
 class Launcher {
 public:
     Launcher(IConfigProvider& config, TableManager* tm, SDL_Renderer* renderer);
-    void draw(std::vector<TableEntry>& tables, bool& editingIni, bool& editingSettings, bool& quitRequested, bool& showCreateIniPrompt, bool& showNoTablePopup);
+    void draw(const TableList& tables, bool& editingIni, bool& editingSettings, bool& quitRequested, bool& showCreateIniPrompt, bool& showNoTablePopup);
     std::string getSelectedIniPath() const { return selectedIniPath; }
     bool getCreateIniConfirmed() const { return createIniConfirmed; }
     void setCreateIniConfirmed(bool confirmed) { createIniConfirmed = confirmed; }
     std::string getSearchQuery() const { return searchQuery; }
+    // Runs the launch or VBS extraction queued by draw(). Both block until the external program
+    // exits, so call this after the frame's TableList is released; holding it would lock out the
+    // updater and the file watcher for the whole game
+    void runPendingOperations();
 private:
     bool isShiftKeyDown() const;
-    void handlePendingOperations(std::vector<TableEntry>& tables);
+    void handlePendingOperations(const TableList& tables);
     IConfigProvider& config;
     TableManager* tableManager;
     SDL_Renderer* renderer;
     TableView tableView;
     TableActions tableActions;
     std::string searchQuery;
+    bool fuzzySearch = false; // Ranked fuzzy matching in the search box
     bool createIniConfirmed;
     std::string selectedIniPath;
     ButtonTooltips buttonTooltips;
@@ -35,8 +40,10 @@ private:
     const float FEEDBACK_MESSAGE_DURATION = 1.5f; // Reduced to 1.5 seconds as requested
     bool pendingExtractVBS = false;
     bool pendingPlay = false;
-    size_t pendingTableIndex = static_cast<size_t>(-1); // Changed to size_t
+    TableId pendingTable = NO_TABLE_ID; // Table the pending operation runs on, by ID so re-sorts can't retarget it
     float delayTimer = 0.0f; // New timer to delay the operation
+    std::string extractPath; // Table queued for runPendingOperations() to extract the VBS of
+    std::string launchPath; // Table queued for runPendingOperations() to launch
     const float DELAY_DURATION = 1.5f; // Delay for 1.5 seconds before starting the operation
 };
 
@@ -1,11 +1,11 @@
 #include "launcher/table_view.h"
-#include <filesystem>
 #include <sstream>
 #include <vector>
+#include <algorithm>
 
-TableView::TableView(TableManager* tm, IConfigProvider& config) : tableManager(tm), config(config), selectedTable(-1) {}
+TableView::TableView(TableManager* tm, IConfigProvider& config) : tableManager(tm), config(config), selectedTable(NO_TABLE_ID) {}
 
-void TableView::drawTable(std::vector<TableEntry>& tables) {
+void TableView::drawTable(const TableList& tables) {
     float dpiScale = ImGui::GetIO().FontGlobalScale;
     if (dpiScale <= 0.0f) dpiScale = 1.0f;
 
@@ -17,6 +17,7 @@ void TableView::drawTable(std::vector<TableEntry>& tables) {
     ImVec2 extraFilesSize = ImGui::CalcTextSize("INI VBS B2S");
     ImVec2 imagesSize = ImGui::CalcTextSize("Wheel Table B2S Marquee");
     ImVec2 videosSize = ImGui::CalcTextSize("Table B2S DMD");
+    ImVec2 playsSize = ImGui::CalcTextSize("Plays");
 
     ImVec2 ultraDmdSize = ImGui::CalcTextSize(u8"✪");
     ImVec2 altSoundSize = ImGui::CalcTextSize(u8"♪");
@@ -30,13 +31,14 @@ void TableView::drawTable(std::vector<TableEntry>& tables) {
     float extraFilesWidth = extraFilesSize.x * padding;
     float imagesWidth = imagesSize.x * padding;
     float videosWidth = videosSize.x * padding;
+    float playsWidth = playsSize.x * padding;
     float adjustedIconWidth = iconWidth * padding;
 
     float authorBaseWidth = 60.0f * dpiScale;
     float versionBaseWidth = 35.0f * dpiScale;
     float romBaseWidth = 65.0f * dpiScale;
 
-    float totalMinWidth = yearWidth + extraFilesWidth + imagesWidth + videosWidth + (adjustedIconWidth * 5);
+    float totalMinWidth = yearWidth + extraFilesWidth + imagesWidth + videosWidth + playsWidth + (adjustedIconWidth * 5);
     float totalVariableWidth = authorBaseWidth + versionBaseWidth + romBaseWidth;
     float totalFixedWidth = totalMinWidth + totalVariableWidth;
 
@@ -54,8 +56,9 @@ void TableView::drawTable(std::vector<TableEntry>& tables) {
     float adjustedVersionWidth = versionBaseWidth * widthScale;
     float adjustedRomWidth = romBaseWidth * widthScale;
 
-    if (ImGui::BeginTable(tableName, 13, ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg | ImGuiTableFlags_ScrollY | 
-                          ImGuiTableFlags_ScrollX | ImGuiTableFlags_Sortable | ImGuiTableFlags_Reorderable | ImGuiTableFlags_Resizable)) {
+    // Shift + click on a header adds it as a secondary sort key
+    if (ImGui::BeginTable(tableName, SortKeys::COLUMN_COUNT, ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg | ImGuiTableFlags_ScrollY | 
+                          ImGuiTableFlags_ScrollX | ImGuiTableFlags_Sortable | ImGuiTableFlags_SortMulti | ImGuiTableFlags_Reorderable | ImGuiTableFlags_Resizable)) {
         ImGui::TableSetupColumn("Year", ImGuiTableColumnFlags_DefaultSort | ImGuiTableColumnFlags_WidthFixed, yearWidth);
         ImGui::TableSetupColumn("Author", ImGuiTableColumnFlags_WidthFixed, adjustedAuthorWidth);
         ImGui::TableSetupColumn("Name", ImGuiTableColumnFlags_WidthStretch);
@@ -69,155 +72,227 @@ void TableView::drawTable(std::vector<TableEntry>& tables) {
         ImGui::TableSetupColumn("Music", ImGuiTableColumnFlags_WidthFixed, adjustedIconWidth);
         ImGui::TableSetupColumn("Images", ImGuiTableColumnFlags_WidthFixed, imagesWidth);
         ImGui::TableSetupColumn("Videos", ImGuiTableColumnFlags_WidthFixed, videosWidth);
+        ImGui::TableSetupColumn("Plays", ImGuiTableColumnFlags_WidthFixed | ImGuiTableColumnFlags_PreferSortDescending, playsWidth);
         ImGui::TableSetupScrollFreeze(0, 1);
         ImGui::TableHeadersRow();
 
         if (ImGuiTableSortSpecs* sortSpecs = ImGui::TableGetSortSpecs()) {
             if (sortSpecs->SpecsDirty) {
-                const ImGuiTableColumnSortSpecs* spec = &sortSpecs->Specs[0];
-                int columnIdx = spec->ColumnIndex;
-                bool isAscending = spec->SortDirection == ImGuiSortDirection_Ascending;
-                tableManager->setSortSpecs(columnIdx, isAscending);
+                std::vector<SortSpec> specs;
+                for (int n = 0; n < sortSpecs->SpecsCount; ++n) {
+                    const ImGuiTableColumnSortSpecs& spec = sortSpecs->Specs[n];
+                    specs.push_back({spec.ColumnIndex, spec.SortDirection == ImGuiSortDirection_Ascending});
+                }
+                tableManager->setSortSpecs(specs);
                 sortSpecs->SpecsDirty = false;
             }
         }
 
-        for (size_t i = 0; i < tables.size(); ++i) {
-            ImGui::TableNextRow(ImGuiTableRowFlags_None, 20.0f * dpiScale);
-            ImGui::PushID(static_cast<int>(i));
-            bool isSelected = (selectedTable == static_cast<int>(i));
-            if (ImGui::TableSetColumnIndex(0)) {
-                char rowLabel[1024];
-                snprintf(rowLabel, sizeof(rowLabel), "%s##%zu", tables[i].year.c_str(), i);
-                bool wasClicked = ImGui::Selectable(rowLabel, &isSelected, ImGuiSelectableFlags_SpanAllColumns | ImGuiSelectableFlags_AllowOverlap);
-                if (wasClicked) {
-                    selectedTable = (selectedTable == static_cast<int>(i)) ? -1 : static_cast<int>(i);
-                }
-                if (ImGui::IsItemHovered()) {
-                    ImGui::BeginTooltip();
-                    // ImGui::Text("Name: %s", tables[i].name.c_str());
-                    ImGui::Text("Filename: %s", tables[i].filename.c_str());
-                    if (tables[i].lastRun == "failed") {
-                        ImGui::TextColored(ImVec4(1.0f, 0.0f, 0.0f, 1.0f), "Failed to launch table.");
+        // Rows have a fixed height, so the clipper can place the visible range without measuring
+        float rowHeight = std::max(20.0f * dpiScale, ImGui::GetTextLineHeight() + 2.0f * ImGui::GetStyle().CellPadding.y);
+        int rowCount = static_cast<int>(tables.size());
+        size_t selectedPosition = tables.find(selectedTable);
+        int selectedRow = selectedPosition != TableList::npos ? static_cast<int>(selectedPosition) : -1;
+        int pageRows = std::max(1, static_cast<int>(ImGui::GetContentRegionAvail().y / rowHeight) - 1);
+        bool scrollToSelected = handleKeyboardNavigation(tables, selectedRow, pageRows);
+
+        // A refresh that inserted or dropped rows above the viewport would shift it to other tables;
+        // probe results patched in while the user scrolls must not move it
+        bool reanchored = false;
+        if (tables.getRowSetVersion() != lastRowSetVersion) {
+            lastRowSetVersion = tables.getRowSetVersion();
+            size_t anchor = tables.find(scrollAnchor);
+            if (anchor != TableList::npos && !scrollToSelected) {
+                ImGui::SetScrollY(static_cast<float>(anchor) * rowHeight + scrollAnchorOffset);
+                reanchored = true;
+            }
+        }
+        if (!reanchored && rowCount > 0) {
+            // SetScrollY() lands next frame, so the anchor is only re-read once it has
+            float scrollY = ImGui::GetScrollY();
+            int topRow = std::clamp(static_cast<int>(scrollY / rowHeight), 0, rowCount - 1);
+            scrollAnchor = tables[topRow].id();
+            scrollAnchorOffset = scrollY - static_cast<float>(topRow) * rowHeight;
+        }
+
+        if (selectedRow >= 0 && ImGui::IsKeyPressed(ImGuiKey_Enter)) {
+            // Launched by the Launcher once the frame's TableList is released, since VPX blocks until it exits
+            launchRequest = tables[selectedRow].filepath();
+        }
+
+        // Only rows inside the scroll viewport get widgets; a row the keyboard just moved to is
+        // submitted too, so it can be scrolled into view
+        ImGuiListClipper clipper;
+        clipper.Begin(rowCount, rowHeight);
+        if (scrollToSelected) clipper.IncludeItemByIndex(selectedRow);
+        while (clipper.Step()) {
+            for (int row = clipper.DisplayStart; row < clipper.DisplayEnd; ++row) {
+                size_t i = static_cast<size_t>(row);
+                ImGui::TableNextRow(ImGuiTableRowFlags_None, rowHeight);
+                ImGui::PushID(row);
+                bool isSelected = (selectedRow == row);
+                const TableRow table = tables[i];
+                if (ImGui::TableSetColumnIndex(0)) {
+                    char rowLabel[1024];
+                    std::string_view year = table.year();
+                    snprintf(rowLabel, sizeof(rowLabel), "%.*s##%zu", static_cast<int>(year.size()), year.data(), i);
+                    bool wasClicked = ImGui::Selectable(rowLabel, &isSelected, ImGuiSelectableFlags_SpanAllColumns | ImGuiSelectableFlags_AllowOverlap);
+                    if (wasClicked) {
+                        selectedTable = (selectedRow == row) ? NO_TABLE_ID : table.id();
+                        selectedRow = (selectedRow == row) ? -1 : row;
                     }
-                    if (tables[i].playCount > 0) {
-                        ImGui::Text("Played: %d time%s", tables[i].playCount, tables[i].playCount == 1 ? "" : "s");
+                    if (scrollToSelected && row == selectedRow) {
+                        ImGui::SetScrollHereY();
                     }
-                    ImGui::EndTooltip();
-                }
-                if (ImGui::IsItemHovered() && ImGui::IsMouseDoubleClicked(0) && selectedTable >= 0) {
-                    std::string folder = std::filesystem::path(tables[selectedTable].filepath).parent_path().string();
-                    std::string cmd = "xdg-open \"" + folder + "\"";
-                    int result = system(cmd.c_str());
-                    if (result != 0) {
-                        LOG_DEBUG("Failed to open table folder: " << folder << " (command: " << cmd << ")");
+                    if (ImGui::IsItemHovered()) {
+                        ImGui::BeginTooltip();
+                        std::string_view filename = table.filename();
+                        ImGui::Text("Filename: %.*s", static_cast<int>(filename.size()), filename.data());
+                        if (table.failed()) {
+                            ImGui::TextColored(ImVec4(1.0f, 0.0f, 0.0f, 1.0f), "Failed to launch table.");
+                        }
+                        if (table.playCount() > 0) {
+                            ImGui::Text("Played: %d time%s", table.playCount(), table.playCount() == 1 ? "" : "s");
+                        }
+                        ImGui::EndTooltip();
                     }
-                }
-                if (isSelected && ImGui::IsKeyPressed(ImGuiKey_Enter) && selectedTable >= 0) {
-                    std::string filepath = tables[selectedTable].filepath;
-                    std::string cmd = config.getStartArgs() + " \"" + config.getCommandToRun() + "\" " + config.getPlaySubCmd() + " \"" + filepath + "\" " + config.getEndArgs();
-                    int result = system(cmd.c_str());
-                    std::string status = (result == 0) ? "success" : "failed";
-                    tableManager->updateTableLastRun(filepath, status);
-                    if (result != 0) {
-                        LOG_DEBUG("Failed to open: " << filepath << " (command: " << cmd << ")");
+                    if (ImGui::IsItemHovered() && ImGui::IsMouseDoubleClicked(0) && selectedRow >= 0) {
+                        std::string folder = tables[selectedRow].folder();
+                        std::string cmd = "xdg-open \"" + folder + "\"";
+                        int result = system(cmd.c_str());
+                        if (result != 0) {
+                            LOG_DEBUG("Failed to open table folder: " << folder << " (command: " << cmd << ")");
+                        }
                     }
-                }
-                ImGui::TableSetColumnIndex(1); ImGui::Text("%s", tables[i].author.c_str());
-                ImGui::TableSetColumnIndex(2); {
-                    if (tables[i].lastRun == "failed") {
-                        ImGui::TextColored(ImVec4(1.0f, 0.0f, 0.0f, 1.0f), "%s", tables[i].name.c_str());
-                    } else {
-                        ImGui::Text("%s", tables[i].name.c_str());
+                    std::string_view author = table.author();
+                    ImGui::TableSetColumnIndex(1); ImGui::TextUnformatted(author.data(), author.data() + author.size());
+                    ImGui::TableSetColumnIndex(2); {
+                        std::string_view name = table.name();
+                        if (table.failed()) {
+                            ImGui::TextColored(ImVec4(1.0f, 0.0f, 0.0f, 1.0f), "%.*s", static_cast<int>(name.size()), name.data());
+                        } else {
+                            ImGui::TextUnformatted(name.data(), name.data() + name.size());
+                        }
                     }
-                }
-                ImGui::TableSetColumnIndex(3); ImGui::Text("%s", tables[i].version.c_str());
-                ImGui::TableSetColumnIndex(4); {
-                    ImVec4 greyColor(0.5f, 0.5f, 0.5f, 1.0f);
-                    ImVec4 whiteColor(1.0f, 1.0f, 1.0f, 1.0f);
-                    ImVec4 yellowColor(1.0f, 1.0f, 0.0f, 1.0f);
-
-                    bool iniExists = tables[i].extraFiles.find("INI") != std::string::npos;
-                    bool iniModified = tables[i].iniModified;
-                    ImVec4 iniColor = iniExists ? (iniModified ? yellowColor : whiteColor) : greyColor;
-                    ImGui::TextColored(iniColor, "INI");
-
-                    ImGui::SameLine();
-                    bool vbsExists = tables[i].extraFiles.find("VBS") != std::string::npos;
-                    bool vbsModified = tables[i].vbsModified;
-                    ImVec4 vbsColor = vbsExists ? (vbsModified ? yellowColor : whiteColor) : greyColor;
-                    ImGui::TextColored(vbsColor, "VBS");
-
-                    ImGui::SameLine();
-                    bool b2sExists = tables[i].extraFiles.find("B2S") != std::string::npos;
-                    ImVec4 b2sColor = b2sExists ? whiteColor : greyColor;
-                    ImGui::TextColored(b2sColor, "B2S");
-                }
-                ImGui::TableSetColumnIndex(5); ImGui::Text("%s", tables[i].rom.c_str());
-                ImGui::TableSetColumnIndex(6); {
-                    if (!tables[i].udmd.empty()) ImGui::TextColored(ImVec4(0.5f, 0, 0.7f, 0.90f), "%s", tables[i].udmd.c_str());
-                }
-                ImGui::TableSetColumnIndex(7); {
-                    if (!tables[i].alts.empty()) ImGui::TextColored(ImVec4(0.4f, 0.6f, 0.9f, 0.85f), "%s", tables[i].alts.c_str());
-                }
-                ImGui::TableSetColumnIndex(8); {
-                    if (!tables[i].altc.empty()) ImGui::TextColored(ImVec4(0.7f, 0.4f, 0, 0.90f), "%s", tables[i].altc.c_str());
-                }
-                ImGui::TableSetColumnIndex(9); {
-                    if (!tables[i].pup.empty()) ImGui::TextColored(ImVec4(0.7f, 0.7f, 0, 0.90f), "%s", tables[i].pup.c_str());
-                }
-                ImGui::TableSetColumnIndex(10); {
-                    if (!tables[i].music.empty()) ImGui::TextColored(ImVec4(0.4f, 0.6f, 0.9f, 0.85f), "%s", tables[i].music.c_str());
-                }
-                ImGui::TableSetColumnIndex(11); {
-                    ImVec4 greenColor(0.0f, 1.0f, 0.0f, 1.0f);
-                    ImVec4 redColor(1.0f, 0.0f, 0.0f, 1.0f);
+                    std::string_view version = table.version();
+                    ImGui::TableSetColumnIndex(3); ImGui::TextUnformatted(version.data(), version.data() + version.size());
+                    // Status glyphs and labels are only chosen here, from the probe bits
+                    const uint32_t status = table.status();
+                    ImGui::TableSetColumnIndex(4); {
+                        ImVec4 greyColor(0.5f, 0.5f, 0.5f, 1.0f);
+                        ImVec4 whiteColor(1.0f, 1.0f, 1.0f, 1.0f);
+                        ImVec4 yellowColor(1.0f, 1.0f, 0.0f, 1.0f);
 
-                    std::string tableDir = std::filesystem::path(tables[i].filepath).parent_path().string();
-                    std::string images = tables[i].images;
+                        bool iniExists = (status & STATUS_INI) != 0;
+                        bool iniModified = table.iniModified();
+                        ImVec4 iniColor = iniExists ? (iniModified ? yellowColor : whiteColor) : greyColor;
+                        ImGui::TextColored(iniColor, "INI");
+                        if (iniModified && ImGui::IsItemHovered()) {
+                            std::string_view overrides = table.iniOverrides();
+                            size_t count = std::count(overrides.begin(), overrides.end(), '\n') + 1;
+                            ImGui::BeginTooltip();
+                            ImGui::Text("Overrides %zu setting%s", count, count == 1 ? "" : "s");
+                            while (!overrides.empty()) {
+                                std::string_view key = overrides.substr(0, overrides.find('\n'));
+                                ImGui::BulletText("%.*s", static_cast<int>(key.size()), key.data());
+                                overrides.remove_prefix(std::min(overrides.size(), key.size() + 1));
+                            }
+                            ImGui::EndTooltip();
+                        }
 
-                    bool wheelExists = images.find("Wheel") != std::string::npos || checkFilePresence(tableDir, config.getWheelImage());
-                    ImGui::TextColored(wheelExists ? greenColor : redColor, "Wheel");
+                        ImGui::SameLine();
+                        bool vbsExists = (status & STATUS_VBS) != 0;
+                        bool vbsModified = table.vbsModified();
+                        ImVec4 vbsColor = vbsExists ? (vbsModified ? yellowColor : whiteColor) : greyColor;
+                        ImGui::TextColored(vbsColor, "VBS");
 
-                    ImGui::SameLine();
-                    bool tableImageExists = images.find("Table") != std::string::npos || checkFilePresence(tableDir, config.getTableImage());
-                    ImGui::TextColored(tableImageExists ? greenColor : redColor, "Table");
-
-                    ImGui::SameLine();
-                    bool b2sImageExists = images.find("B2S") != std::string::npos || checkFilePresence(tableDir, config.getBackglassImage());
-                    ImGui::TextColored(b2sImageExists ? greenColor : redColor, "B2S");
+                        ImGui::SameLine();
+                        bool b2sExists = (status & STATUS_B2S) != 0;
+                        ImVec4 b2sColor = b2sExists ? whiteColor : greyColor;
+                        ImGui::TextColored(b2sColor, "B2S");
+                    }
+                    ImGui::TableSetColumnIndex(5); {
+                        std::string_view gameName = table.gameName();
+                        if (status & STATUS_ROM) ImGui::TextUnformatted(gameName.data(), gameName.data() + gameName.size());
+                    }
+                    ImGui::TableSetColumnIndex(6); {
+                        if (status & STATUS_ULTRADMD) ImGui::TextColored(ImVec4(0.5f, 0, 0.7f, 0.90f), u8"✪");
+                    }
+                    ImGui::TableSetColumnIndex(7); {
+                        if (status & STATUS_ALTSOUND) ImGui::TextColored(ImVec4(0.4f, 0.6f, 0.9f, 0.85f), u8"♪");
+                    }
+                    ImGui::TableSetColumnIndex(8); {
+                        if (status & STATUS_ALTCOLOR) ImGui::TextColored(ImVec4(0.7f, 0.4f, 0, 0.90f), u8"☀");
+                    }
+                    ImGui::TableSetColumnIndex(9); {
+                        if (status & STATUS_PUPPACK) ImGui::TextColored(ImVec4(0.7f, 0.7f, 0, 0.90f), u8"▣");
+                    }
+                    ImGui::TableSetColumnIndex(10); {
+                        if (status & STATUS_MUSIC) ImGui::TextColored(ImVec4(0.4f, 0.6f, 0.9f, 0.85f), u8"♫");
+                    }
+                    // Media presence comes from the last probe of the row, which the table watcher
+                    // refreshes when files change; nothing here touches the filesystem
+                    ImGui::TableSetColumnIndex(11); {
+                        ImVec4 greenColor(0.0f, 1.0f, 0.0f, 1.0f);
+                        ImVec4 redColor(1.0f, 0.0f, 0.0f, 1.0f);
+                        bool wheelExists = (status & STATUS_WHEEL_IMAGE) != 0;
+                        ImGui::TextColored(wheelExists ? greenColor : redColor, "Wheel");
 
-                    ImGui::SameLine();
-                    bool marqueeExists = images.find("Marquee") != std::string::npos || checkFilePresence(tableDir, config.getMarqueeImage());
-                    ImGui::TextColored(marqueeExists ? greenColor : redColor, "Marquee");
-                }
-                ImGui::TableSetColumnIndex(12); {
-                    ImVec4 greenColor(0.0f, 1.0f, 0.0f, 1.0f);
-                    ImVec4 redColor(1.0f, 0.0f, 0.0f, 1.0f);
+                        ImGui::SameLine();
+                        bool tableImageExists = (status & STATUS_TABLE_IMAGE) != 0;
+                        ImGui::TextColored(tableImageExists ? greenColor : redColor, "Table");
 
-                    std::string tableDir = std::filesystem::path(tables[i].filepath).parent_path().string();
-                    std::string videos = tables[i].videos;
+                        ImGui::SameLine();
+                        bool b2sImageExists = (status & STATUS_BACKGLASS_IMAGE) != 0;
+                        ImGui::TextColored(b2sImageExists ? greenColor : redColor, "B2S");
 
-                    bool tableVideoExists = videos.find("Table") != std::string::npos || checkFilePresence(tableDir, config.getTableVideo());
-                    ImGui::TextColored(tableVideoExists ? greenColor : redColor, "Table");
+                        ImGui::SameLine();
+                        bool marqueeExists = (status & STATUS_MARQUEE_IMAGE) != 0;
+                        ImGui::TextColored(marqueeExists ? greenColor : redColor, "Marquee");
+                    }
+                    ImGui::TableSetColumnIndex(12); {
+                        ImVec4 greenColor(0.0f, 1.0f, 0.0f, 1.0f);
+                        ImVec4 redColor(1.0f, 0.0f, 0.0f, 1.0f);
+                        bool tableVideoExists = (status & STATUS_TABLE_VIDEO) != 0;
+                        ImGui::TextColored(tableVideoExists ? greenColor : redColor, "Table");
 
-                    ImGui::SameLine();
-                    bool b2sVideoExists = videos.find("B2S") != std::string::npos || checkFilePresence(tableDir, config.getBackglassVideo());
-                    ImGui::TextColored(b2sVideoExists ? greenColor : redColor, "B2S");
+                        ImGui::SameLine();
+                        bool b2sVideoExists = (status & STATUS_BACKGLASS_VIDEO) != 0;
+                        ImGui::TextColored(b2sVideoExists ? greenColor : redColor, "B2S");
 
-                    ImGui::SameLine();
-                    bool dmdVideoExists = videos.find("DMD") != std::string::npos || checkFilePresence(tableDir, config.getDmdVideo());
-                    ImGui::TextColored(dmdVideoExists ? greenColor : redColor, "DMD");
+                        ImGui::SameLine();
+                        bool dmdVideoExists = (status & STATUS_DMD_VIDEO) != 0;
+                        ImGui::TextColored(dmdVideoExists ? greenColor : redColor, "DMD");
+                    }
+                    ImGui::TableSetColumnIndex(13); {
+                        if (table.playCount() > 0) ImGui::Text("%d", table.playCount());
+                    }
                 }
+                ImGui::PopID();
             }
-            ImGui::PopID();
         }
+        clipper.End();
         ImGui::EndTable();
     }
 
     ImGui::PopStyleVar();
 }
 
-bool TableView::checkFilePresence(const std::string& tablePath, const std::string& relativePath) {
-    return std::filesystem::exists(tablePath + "/" + relativePath);
-}
\ No newline at end of file
+bool TableView::handleKeyboardNavigation(const TableList& tables, int& selectedRow, int pageRows) {
+    int rowCount = static_cast<int>(tables.size());
+    if (rowCount == 0) return false;
+    // Home/End belong to the search field while it is being edited
+    bool typing = ImGui::GetIO().WantTextInput;
+    int target = selectedRow;
+    if (ImGui::IsKeyPressed(ImGuiKey_DownArrow)) target = selectedRow < 0 ? 0 : selectedRow + 1;
+    else if (ImGui::IsKeyPressed(ImGuiKey_UpArrow)) target = selectedRow < 0 ? 0 : selectedRow - 1;
+    else if (ImGui::IsKeyPressed(ImGuiKey_PageDown)) target = std::max(selectedRow, 0) + pageRows;
+    else if (ImGui::IsKeyPressed(ImGuiKey_PageUp)) target = std::max(selectedRow, 0) - pageRows;
+    else if (!typing && ImGui::IsKeyPressed(ImGuiKey_Home)) target = 0;
+    else if (!typing && ImGui::IsKeyPressed(ImGuiKey_End)) target = rowCount - 1;
+    else return false;
+
+    selectedRow = std::clamp(target, 0, rowCount - 1);
+    selectedTable = tables[selectedRow].id();
+    return true;
+}
@@ -6,17 +6,35 @@
 #include "tables/table_manager.h"
 #include "config/iconfig_provider.h"
 #include <imgui.h>
+#include <string>
+#include <utility>
 
 class TableView {
 public:
     TableView(TableManager* tm, IConfigProvider& config);
-    void drawTable(std::vector<TableEntry>& tables);
-    int getSelectedTable() const { return selectedTable; }
+    void drawTable(const TableList& tables);
+    // Returns: ID of the selected table, NO_TABLE_ID if none; look it up with TableList::find()
+    TableId getSelectedTable() const { return selectedTable; }
+    // Returns: Filepath of the table Enter was pressed on since the last call, empty if none
+    std::string takeLaunchRequest() { return std::exchange(launchRequest, std::string()); }
 private:
     TableManager* tableManager;
     IConfigProvider& config;
-    int selectedTable;
-    bool checkFilePresence(const std::string& tablePath, const std::string& relativePath);
+    // Kept by ID, so the selection stays on its table when rows are re-sorted, refreshed or
+    // filtered out and back in
+    TableId selectedTable;
+    // First row at the top of the viewport and how far it is scrolled past; when rows are added
+    // or removed above it, the scroll position is moved so the same table stays on top
+    TableId scrollAnchor = NO_TABLE_ID;
+    float scrollAnchorOffset = 0.0f;
+    uint64_t lastRowSetVersion = 0;
+    std::string launchRequest;
+    // Moves the selection with the arrow, page and Home/End keys, independent of which rows are drawn
+    // tables: Filtered view the keys move through
+    // selectedRow: Position of the selection in tables, -1 if none; updated with the new position
+    // pageRows: Rows moved by PageUp/PageDown
+    // Returns: true if a key moved the selection and the row should be scrolled into view
+    bool handleKeyboardNavigation(const TableList& tables, int& selectedRow, int pageRows);
 };
 
 #endif // TABLE_VIEW_H
\ No newline at end of file
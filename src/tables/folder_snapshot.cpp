@@ -0,0 +1,82 @@
+#include "tables/folder_snapshot.h"
+#include "utils/logging.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+
+FolderSnapshot::FolderSnapshot(const std::string& folder, const std::vector<std::string>& probePaths) : folder(folder) {
+    valid = list("");
+    if (!valid) return;
+
+    // Shallowest first, so a missing parent skips its children
+    for (const auto& dir : subdirectories(probePaths)) {
+        if (directories.count(dir)) list(dir);
+    }
+}
+
+std::vector<std::string> FolderSnapshot::subdirectories(const std::vector<std::string>& probePaths) {
+    // Every ancestor directory of a probe path
+    std::vector<std::string> subdirs;
+    for (const auto& probe : probePaths) {
+        std::string path = normalize(probe);
+        for (size_t slash = path.find('/'); slash != std::string::npos; slash = path.find('/', slash + 1)) {
+            subdirs.push_back(path.substr(0, slash));
+        }
+    }
+    std::sort(subdirs.begin(), subdirs.end(), [](const std::string& a, const std::string& b) {
+        size_t depthA = std::count(a.begin(), a.end(), '/');
+        size_t depthB = std::count(b.begin(), b.end(), '/');
+        return depthA != depthB ? depthA < depthB : a < b;
+    });
+    subdirs.erase(std::unique(subdirs.begin(), subdirs.end()), subdirs.end());
+    return subdirs;
+}
+
+bool FolderSnapshot::exists(const std::string& relativePath) const {
+    return entries.count(normalize(relativePath)) > 0;
+}
+
+bool FolderSnapshot::hasDirectoryWithSuffix(const std::string& suffix) const {
+    for (const auto& dir : directories) {
+        if (dir.find('/') == std::string::npos && dir.size() >= suffix.size() &&
+            dir.compare(dir.size() - suffix.size(), suffix.size(), suffix) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool FolderSnapshot::list(const std::string& relativeDir) {
+    std::string path = relativeDir.empty() ? folder : folder + "/" + relativeDir;
+    DIR* dir = opendir(path.c_str());
+    if (!dir) {
+        LOG_DEBUG("Failed to list " << path << ": " << std::strerror(errno));
+        return false;
+    }
+    const std::string prefix = relativeDir.empty() ? "" : relativeDir + "/";
+    int fd = dirfd(dir);
+    while (struct dirent* entry = readdir(dir)) {
+        if (std::strcmp(entry->d_name, ".") == 0 || std::strcmp(entry->d_name, "..") == 0) continue;
+        std::string name = prefix + entry->d_name;
+        bool isDir = entry->d_type == DT_DIR;
+        if (entry->d_type == DT_UNKNOWN || entry->d_type == DT_LNK) {
+            // Some filesystems leave d_type unset; symlinked media folders must be followed
+            struct stat st;
+            isDir = fstatat(fd, entry->d_name, &st, 0) == 0 && S_ISDIR(st.st_mode);
+        }
+        if (isDir) directories.insert(name);
+        entries.insert(std::move(name));
+    }
+    closedir(dir);
+    return true;
+}
+
+std::string FolderSnapshot::normalize(const std::string& relativePath) {
+    size_t start = relativePath.find_first_not_of('/');
+    if (start == std::string::npos) return "";
+    size_t end = relativePath.find_last_not_of('/');
+    return relativePath.substr(start, end - start + 1);
+}
\ No newline at end of file
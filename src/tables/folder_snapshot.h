@@ -0,0 +1,48 @@
+#ifndef FOLDER_SNAPSHOT_H
+#define FOLDER_SNAPSHOT_H
+
+#include <string>
+#include <vector>
+#include <unordered_set>
+
+// Directory listing of a table folder, taken with one readdir per directory.
+// Besides the folder itself only the subfolders leading to the given probe paths are
+// listed, and only if their parent listing shows them, so presence checks for media,
+// ROMs and sidecar files never touch the filesystem again.
+class FolderSnapshot {
+public:
+    // Lists folder and every existing ancestor directory of the probe paths
+    // folder: Table folder to list
+    // probePaths: Paths relative to folder that will be checked, e.g. "/images/wheel.png"
+    FolderSnapshot(const std::string& folder, const std::vector<std::string>& probePaths);
+
+    // Subfolders the constructor lists for the given probe paths, relative and shallowest first
+    static std::vector<std::string> subdirectories(const std::vector<std::string>& probePaths);
+
+    // Checks whether a file or directory existed when the snapshot was taken
+    // relativePath: Path below the folder; a leading slash is ignored
+    // Returns: false as well if its parent directory was not listed
+    bool exists(const std::string& relativePath) const;
+
+    // Checks whether the folder itself holds a directory whose name ends with suffix
+    bool hasDirectoryWithSuffix(const std::string& suffix) const;
+
+    // Returns: false if the folder could not be listed
+    bool isValid() const { return valid; }
+
+    const std::string& getFolder() const { return folder; }
+
+private:
+    // Lists one directory and records its entries relative to the table folder
+    // relativeDir: Directory below folder, empty for the folder itself
+    bool list(const std::string& relativeDir);
+
+    static std::string normalize(const std::string& relativePath);
+
+    std::string folder;
+    bool valid = false;
+    std::unordered_set<std::string> entries;     // Every listed name, relative to folder
+    std::unordered_set<std::string> directories; // Subset of entries that are directories
+};
+
+#endif // FOLDER_SNAPSHOT_H
\ No newline at end of file
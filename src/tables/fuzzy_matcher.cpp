@@ -0,0 +1,113 @@
+#include "tables/fuzzy_matcher.h"
+#include "tables/search_index.h"
+#include <algorithm>
+
+namespace {
+
+const int SCORE_MATCH = 16;       // Every matched letter
+const int BONUS_WORD_START = 24;  // Letter starts a word in the field
+const int BONUS_FIELD_START = 8;  // Letter is the first of the field
+const int BONUS_CONSECUTIVE = 16; // Letter directly follows the previous match
+const int MAX_GAP_PENALTY = 8;    // Cap for letters skipped between two matches
+const int SCORE_INITIAL = 40;     // Per letter of a word matched through initials
+
+// Folded keys only hold lowercase letters, digits, punctuation and UTF-8 continuation bytes
+inline bool isWordChar(unsigned char c) {
+    return (c >= 'a' && c <= 'z') || (c >= '0' && c <= '9') || c >= 0x80;
+}
+
+// Splits a "first<sep>second" search key into its two fields
+inline void splitKey(std::string_view key, std::string_view& first, std::string_view& second) {
+    size_t sep = key.find(SearchIndex::KEY_SEPARATOR);
+    first = key.substr(0, sep);
+    second = sep == std::string_view::npos ? std::string_view() : key.substr(sep + 1);
+}
+
+} // namespace
+
+FuzzyMatcher::FuzzyMatcher(const std::string& foldedQuery) {
+    size_t pos = 0;
+    while (pos < foldedQuery.size()) {
+        size_t end = foldedQuery.find(' ', pos);
+        if (end == std::string::npos) end = foldedQuery.size();
+        if (end > pos) words.push_back(foldedQuery.substr(pos, end - pos));
+        pos = end + 1;
+    }
+    queryMask = SearchIndex::charMask(foldedQuery);
+}
+
+int FuzzyMatcher::score(std::string_view searchKey, std::string_view fuzzyKey) const {
+    if (words.empty()) return 1; // Only spaces: everything matches equally
+    std::string_view name, filename, author, rom;
+    splitKey(searchKey, name, filename);
+    splitKey(fuzzyKey, author, rom);
+
+    int total = 0;
+    for (const auto& word : words) {
+        // Name matches count fully; the other fields only break ties between weaker name matches
+        int best = std::max(scoreSubsequence(name, word), scoreInitials(name, word));
+        best = std::max(best, scoreSubsequence(filename, word) * 3 / 4);
+        best = std::max(best, scoreSubsequence(rom, word) * 3 / 4);
+        best = std::max(best, scoreSubsequence(author, word) / 2);
+        if (best == 0) return 0;
+        total += best;
+    }
+    return total;
+}
+
+int FuzzyMatcher::scoreSubsequence(std::string_view text, std::string_view word) {
+    if (word.empty() || word.size() > text.size()) return 0;
+
+    // Forward pass: earliest position where the whole word has been matched
+    size_t w = 0, end = 0;
+    for (size_t i = 0; i < text.size() && w < word.size(); ++i) {
+        if (text[i] == word[w]) {
+            if (++w == word.size()) end = i;
+        }
+    }
+    if (w < word.size()) return 0;
+
+    // Backward pass from there: latest start, which gives the tightest window
+    size_t start = end;
+    w = word.size();
+    for (size_t i = end + 1; i-- > 0;) {
+        if (text[i] == word[w - 1] && --w == 0) {
+            start = i;
+            break;
+        }
+    }
+
+    int score = 0;
+    size_t prev = std::string_view::npos;
+    w = 0;
+    for (size_t i = start; i <= end && w < word.size(); ++i) {
+        if (text[i] != word[w]) continue;
+        int letter = SCORE_MATCH;
+        if (i == 0) letter += BONUS_FIELD_START;
+        if (i == 0 || !isWordChar(static_cast<unsigned char>(text[i - 1]))) letter += BONUS_WORD_START;
+        if (prev != std::string_view::npos) {
+            if (prev + 1 == i) letter += BONUS_CONSECUTIVE;
+            else letter -= static_cast<int>(std::min<size_t>(i - prev - 1, MAX_GAP_PENALTY));
+        }
+        score += letter;
+        prev = i;
+        ++w;
+    }
+    return std::max(score, 1);
+}
+
+int FuzzyMatcher::scoreInitials(std::string_view text, std::string_view word) {
+    if (word.size() < 2) return 0;
+    char buffer[64]; // Names with more words only match on their first 64 initials
+    size_t count = 0;
+    for (size_t i = 0; i < text.size() && count < sizeof(buffer); ++i) {
+        unsigned char c = static_cast<unsigned char>(text[i]);
+        if (isWordChar(c) && c < 0x80 && (i == 0 || !isWordChar(static_cast<unsigned char>(text[i - 1])))) {
+            buffer[count++] = static_cast<char>(c);
+        }
+    }
+    size_t pos = std::string_view(buffer, count).find(word);
+    if (pos == std::string::npos) return 0;
+    // Initials from the first word on are a stronger hint than ones picked up mid-name
+    return SCORE_INITIAL * static_cast<int>(word.size()) + (pos == 0 ? BONUS_FIELD_START * 2 : 0);
+}
\ No newline at end of file
@@ -0,0 +1,41 @@
+#ifndef FUZZY_MATCHER_H
+#define FUZZY_MATCHER_H
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <cstdint>
+
+// Ranked fuzzy matching for the launcher search box. The query is split on spaces and every
+// word has to match one field of a row (name, filename, author or ROM) as a subsequence or
+// through the initials of the name ("tz" finds "Twilight Zone"). Word starts, consecutive
+// letters and prefixes score higher, and the row score is the sum over the query words.
+class FuzzyMatcher {
+public:
+    // foldedQuery: Query passed through SearchIndex::fold()
+    explicit FuzzyMatcher(const std::string& foldedQuery);
+
+    bool empty() const { return words.empty(); }
+
+    // SearchIndex::charMask() of the whole query; rows lacking any of its bits can't match
+    uint64_t getQueryMask() const { return queryMask; }
+
+    // Scores a row by its search keys
+    // searchKey, fuzzyKey: The row's TableStore::searchKey() and fuzzyKey()
+    // Returns: 0 if some query word matches none of the fields, otherwise a positive score
+    int score(std::string_view searchKey, std::string_view fuzzyKey) const;
+
+private:
+    // Scores word as a subsequence of text, on the tightest window that contains it
+    // Returns: 0 if text does not contain the letters of word in order
+    static int scoreSubsequence(std::string_view text, std::string_view word);
+
+    // Scores word against the first letters of the words in text
+    // Returns: 0 unless word (two letters or more) appears in the initials
+    static int scoreInitials(std::string_view text, std::string_view word);
+
+    std::vector<std::string> words;
+    uint64_t queryMask = 0;
+};
+
+#endif // FUZZY_MATCHER_H
\ No newline at end of file
@@ -0,0 +1,74 @@
+#include "tables/ini_settings.h"
+#include "utils/logging.h"
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <fstream>
+
+namespace {
+
+std::string trim(const std::string& s) {
+    size_t start = s.find_first_not_of(" \t\r\n");
+    if (start == std::string::npos) return "";
+    size_t end = s.find_last_not_of(" \t\r\n");
+    return s.substr(start, end - start + 1);
+}
+
+std::string toLower(std::string s) {
+    std::transform(s.begin(), s.end(), s.begin(), [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    return s;
+}
+
+bool parseNumber(const std::string& s, double& out) {
+    if (s.empty()) return false;
+    char* end = nullptr;
+    out = std::strtod(s.c_str(), &end);
+    return end == s.c_str() + s.size();
+}
+
+} // namespace
+
+bool IniSettings::load(const std::string& path) {
+    values.clear();
+    std::ifstream file(path);
+    if (!file.is_open()) {
+        LOG_DEBUG("Could not open " << path);
+        return false;
+    }
+
+    std::string line, section;
+    while (std::getline(file, line)) {
+        std::string trimmed = trim(line);
+        if (trimmed.empty() || trimmed[0] == ';' || trimmed[0] == '#') continue;
+        if (trimmed.front() == '[' && trimmed.back() == ']') {
+            section = trim(trimmed.substr(1, trimmed.size() - 2));
+            continue;
+        }
+        size_t pos = trimmed.find('=');
+        if (pos == std::string::npos || section.empty()) continue;
+        std::string key = trim(trimmed.substr(0, pos));
+        if (key.empty()) continue;
+        std::string name = section + "/" + key;
+        values[toLower(name)] = {name, trim(trimmed.substr(pos + 1))};
+    }
+    return true;
+}
+
+std::vector<std::string> IniSettings::overridesOf(const IniSettings& base) const {
+    std::vector<std::string> overrides;
+    for (const auto& [key, setting] : values) {
+        if (setting.value.empty()) continue;
+        auto it = base.values.find(key);
+        if (it == base.values.end() || !sameValue(setting.value, it->second.value)) {
+            overrides.push_back(setting.name);
+        }
+    }
+    std::sort(overrides.begin(), overrides.end());
+    return overrides;
+}
+
+bool IniSettings::sameValue(const std::string& a, const std::string& b) {
+    if (a == b) return true;
+    double x, y;
+    return parseNumber(a, x) && parseNumber(b, y) && x == y;
+}
\ No newline at end of file
@@ -0,0 +1,37 @@
+#ifndef INI_SETTINGS_H
+#define INI_SETTINGS_H
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+
+// Flat key/value model of a VPinballX-style INI file for semantic comparison.
+// Keys are stored as "Section/Key" with section and key lowercased; values are trimmed,
+// so whitespace, ordering and letter case of names never count as differences.
+class IniSettings {
+public:
+    // Parses an INI file, replacing any previous contents
+    // path: INI file to read
+    // Returns: false if the file could not be opened
+    bool load(const std::string& path);
+
+    // Lists the settings this file overrides relative to base
+    // base: Global settings, usually VPinballX.ini
+    // Returns: "Section/Key" names (as written in this file) whose value is set here and differs
+    //          from base; empty values mean "use the global setting" and are skipped
+    std::vector<std::string> overridesOf(const IniSettings& base) const;
+
+    size_t size() const { return values.size(); }
+
+private:
+    // Numbers compare by value so "1" and "1.000000" are the same setting
+    static bool sameValue(const std::string& a, const std::string& b);
+
+    struct Setting {
+        std::string name;  // "Section/Key" as written
+        std::string value; // Trimmed value
+    };
+    std::unordered_map<std::string, Setting> values; // Lowercased "section/key" -> setting
+};
+
+#endif // INI_SETTINGS_H
\ No newline at end of file
@@ -0,0 +1,174 @@
+#include "tables/name_normalizer.h"
+
+namespace {
+
+// Character classes of the C locale, which the old <cctype>/regex parsing ran in
+bool isSpace(char c) {
+    return c == ' ' || (c >= '\t' && c <= '\r');
+}
+
+bool isDigit(char c) {
+    return c >= '0' && c <= '9';
+}
+
+// Regex \w: a year must not touch one of these on either side
+bool isWordChar(char c) {
+    return isDigit(c) || (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || c == '_';
+}
+
+char toLower(char c) {
+    return c >= 'A' && c <= 'Z' ? static_cast<char>(c - 'A' + 'a') : c;
+}
+
+bool equalsIgnoreCase(std::string_view a, std::string_view b) {
+    if (a.size() != b.size()) return false;
+    for (size_t i = 0; i < a.size(); ++i) {
+        if (toLower(a[i]) != toLower(b[i])) return false;
+    }
+    return true;
+}
+
+// FNV-1a over the lowercased bytes
+uint32_t hashWord(std::string_view word) {
+    uint32_t hash = 2166136261u;
+    for (char c : word) {
+        hash ^= static_cast<unsigned char>(toLower(c));
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+std::string_view trim(std::string_view text, std::string_view extra = {}) {
+    auto strip = [&](char c) { return isSpace(c) || extra.find(c) != std::string_view::npos; };
+    while (!text.empty() && strip(text.front())) text.remove_prefix(1);
+    while (!text.empty() && strip(text.back())) text.remove_suffix(1);
+    return text;
+}
+
+// Calls visit(word) for each whitespace-separated word of text; stops early when it returns false
+template <typename Visit>
+void forEachWord(std::string_view text, Visit visit) {
+    size_t pos = 0;
+    while (pos < text.size()) {
+        while (pos < text.size() && isSpace(text[pos])) ++pos;
+        size_t start = pos;
+        while (pos < text.size() && !isSpace(text[pos])) ++pos;
+        if (pos > start && !visit(text.substr(start, pos - start))) return;
+    }
+}
+
+// Length of a run of one or two digits at pos that is followed by a date separator, else 0
+size_t dateField(std::string_view text, size_t pos) {
+    size_t len = 0;
+    while (len < 2 && pos + len < text.size() && isDigit(text[pos + len])) ++len;
+    if (len == 0 || pos + len >= text.size()) return 0;
+    char next = text[pos + len];
+    return next == '/' || next == '-' ? len : 0;
+}
+
+// Finds the first D/M/YY or DD-MM-YY date on word boundaries
+// Returns: View of its two-digit year, empty if there is none
+std::string_view findShortDate(std::string_view text) {
+    for (size_t start = 0; start < text.size(); ++start) {
+        if (!isDigit(text[start]) || (start > 0 && isWordChar(text[start - 1]))) continue;
+        size_t day = dateField(text, start);
+        if (day == 0) continue;
+        size_t month = dateField(text, start + day + 1);
+        if (month == 0) continue;
+        size_t year = start + day + 1 + month + 1;
+        if (year + 2 > text.size() || !isDigit(text[year]) || !isDigit(text[year + 1])) continue;
+        if (year + 2 < text.size() && isWordChar(text[year + 2])) continue;
+        return text.substr(year, 2);
+    }
+    return {};
+}
+
+} // namespace
+
+NameParts NameNormalizer::parse(std::string_view text) {
+    NameParts parts;
+    size_t open = text.find('(');
+    parts.title = trim(text.substr(0, open));
+    parts.year = findYear(text);
+
+    if (open != std::string_view::npos) {
+        std::string_view inner = text.substr(open + 1);
+        inner = inner.substr(0, inner.find(')'));
+        std::string_view year = findYear(inner);
+        if (year.empty()) {
+            parts.manufacturer = trim(inner, ",");
+        } else {
+            // "(Williams 1997)" or "(1997 Williams)": whichever side of the year has text
+            size_t at = static_cast<size_t>(year.data() - inner.data());
+            std::string_view before = trim(inner.substr(0, at), ",");
+            parts.manufacturer = !before.empty() ? before : trim(inner.substr(at + year.size()), ",");
+        }
+    }
+
+    forEachWord(parts.title, [&parts](std::string_view word) {
+        if (parts.wordCount == NameParts::MAX_WORDS) {
+            parts.truncated = true;
+            return false;
+        }
+        uint32_t hash = hashWord(word);
+        parts.words[parts.wordCount] = word;
+        parts.wordHashes[parts.wordCount] = hash;
+        parts.wordMask |= uint64_t(1) << (hash % 64);
+        ++parts.wordCount;
+        return true;
+    });
+    return parts;
+}
+
+bool NameNormalizer::sharesWord(const NameParts& a, const NameParts& b) {
+    if (a.truncated || b.truncated) {
+        // Very long titles: compare every pair of words instead of the hashed prefix
+        bool shared = false;
+        forEachWord(a.title, [&](std::string_view wordA) {
+            forEachWord(b.title, [&](std::string_view wordB) {
+                shared = equalsIgnoreCase(wordA, wordB);
+                return !shared;
+            });
+            return !shared;
+        });
+        return shared;
+    }
+
+    if ((a.wordMask & b.wordMask) == 0) return false;
+    for (size_t i = 0; i < a.wordCount; ++i) {
+        if ((b.wordMask & (uint64_t(1) << (a.wordHashes[i] % 64))) == 0) continue;
+        for (size_t j = 0; j < b.wordCount; ++j) {
+            // Equal hashes are confirmed, so a collision never counts as a shared word
+            if (a.wordHashes[i] == b.wordHashes[j] && equalsIgnoreCase(a.words[i], b.words[j])) return true;
+        }
+    }
+    return false;
+}
+
+std::string_view NameNormalizer::findYear(std::string_view text) {
+    for (size_t i = 0; i + 4 <= text.size(); ++i) {
+        bool century = (text[i] == '1' && text[i + 1] == '9') || (text[i] == '2' && text[i + 1] == '0');
+        if (!century || !isDigit(text[i + 2]) || !isDigit(text[i + 3])) continue;
+        if (i > 0 && isWordChar(text[i - 1])) continue;
+        if (i + 4 < text.size() && isWordChar(text[i + 4])) continue;
+        return text.substr(i, 4);
+    }
+    return {};
+}
+
+std::string NameNormalizer::releaseYear(std::string_view releaseDate) {
+    if (releaseDate.empty()) return "";
+
+    // DD.MM.YYYY, with whatever separators, as long as the year sits at offset 6
+    if (releaseDate.size() >= 10 && isDigit(releaseDate[6]) && isDigit(releaseDate[7]) &&
+        isDigit(releaseDate[8]) && isDigit(releaseDate[9])) {
+        return std::string(releaseDate.substr(6, 4));
+    }
+
+    std::string_view shortYear = findShortDate(releaseDate);
+    if (!shortYear.empty()) {
+        return "19" + std::string(shortYear);
+    }
+
+    return std::string(findYear(releaseDate));
+}
\ No newline at end of file
@@ -0,0 +1,49 @@
+#ifndef NAME_NORMALIZER_H
+#define NAME_NORMALIZER_H
+
+#include <array>
+#include <string>
+#include <string_view>
+#include <cstdint>
+#include <cstddef>
+
+// A table name or filename such as "Medieval Madness (Williams 1997) VPW 1.2", split once
+// into the candidates the loader picks from. All views point into the parsed text, which
+// must outlive the NameParts.
+struct NameParts {
+    static constexpr size_t MAX_WORDS = 32;
+
+    std::string_view title;        // Text before the first '(', trimmed: "Medieval Madness"
+    std::string_view manufacturer; // Parenthesized text without its year: "Williams"
+    std::string_view year;         // First standalone 19xx/20xx anywhere in the text: "1997"
+
+    // Whitespace-separated words of title with their case-insensitive hashes; wordMask has
+    // bit (hash % 64) set for every word, so most titles sharing no word are rejected at once
+    std::array<std::string_view, MAX_WORDS> words;
+    std::array<uint32_t, MAX_WORDS> wordHashes;
+    size_t wordCount = 0;
+    uint64_t wordMask = 0;
+    bool truncated = false; // title has more than MAX_WORDS words
+};
+
+// Hand-written scanners for the names and release dates found in table metadata, replacing
+// the regex and stringstream parsing. Nothing here allocates except releaseYear()'s result.
+class NameNormalizer {
+public:
+    // Tokenizes text once into its title words, manufacturer and year candidates
+    static NameParts parse(std::string_view text);
+
+    // Returns: true if both titles share a word, ignoring ASCII case
+    static bool sharesWord(const NameParts& a, const NameParts& b);
+
+    // Finds the first 19xx or 20xx that is not part of a longer word or number
+    // Returns: View into text, empty if there is none
+    static std::string_view findYear(std::string_view text);
+
+    // Year of a release date as written by table authors: DD.MM.YYYY (any separators),
+    // D/M/YY or DD-MM-YY (taken as 19YY), else any year inside the text
+    // Returns: Four-digit year, empty if none was found
+    static std::string releaseYear(std::string_view releaseDate);
+};
+
+#endif // NAME_NORMALIZER_H
\ No newline at end of file
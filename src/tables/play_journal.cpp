@@ -0,0 +1,243 @@
+#include "tables/play_journal.h"
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+
+const char JOURNAL_MAGIC[8] = {'V', 'P', 'X', 'G', 'T', 'J', 'N', 'L'};
+
+struct JournalHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t reserved;
+};
+
+// Followed by pathLength bytes of path
+struct RecordHeader {
+    uint32_t pathLength;
+    int32_t playCount;
+    int64_t time;      // ns since epoch when the record was written
+    uint8_t lastRun;   // Index into LAST_RUN_NAMES
+    uint8_t reserved[3];
+    uint32_t checksum; // recordChecksum() of the record with this field zeroed
+};
+
+static_assert(sizeof(JournalHeader) == 16, "JournalHeader layout is part of the file format");
+static_assert(sizeof(RecordHeader) == 24, "RecordHeader layout is part of the file format");
+
+const char* const LAST_RUN_NAMES[] = {"clear", "success", "failed"};
+const uint8_t LAST_RUN_COUNT = 3;
+const uint32_t MAX_PATH_LENGTH = 1u << 16;
+
+uint8_t lastRunCode(const std::string& lastRun) {
+    for (uint8_t i = 0; i < LAST_RUN_COUNT; ++i) {
+        if (lastRun == LAST_RUN_NAMES[i]) return i;
+    }
+    return 0;
+}
+
+// FNV-1a over the record header and the path
+uint32_t recordChecksum(const RecordHeader& header, const char* path) {
+    RecordHeader zeroed = header;
+    zeroed.checksum = 0;
+    uint32_t hash = 2166136261u;
+    auto mix = [&hash](const char* data, size_t size) {
+        for (size_t i = 0; i < size; ++i) {
+            hash ^= static_cast<unsigned char>(data[i]);
+            hash *= 16777619u;
+        }
+    };
+    mix(reinterpret_cast<const char*>(&zeroed), sizeof(zeroed));
+    mix(path, header.pathLength);
+    return hash;
+}
+
+bool writeAll(int fd, const char* data, size_t size) {
+    while (size > 0) {
+        ssize_t written = ::write(fd, data, size);
+        if (written < 0) {
+            if (errno == EINTR) continue;
+            return false;
+        }
+        data += written;
+        size -= static_cast<size_t>(written);
+    }
+    return true;
+}
+
+// Writes one record with a single write() so a crash can only tear the last record
+bool writeRecord(int fd, const std::string& filepath, const PlayState& state) {
+    RecordHeader header;
+    std::memset(&header, 0, sizeof(header));
+    header.pathLength = static_cast<uint32_t>(filepath.size());
+    header.playCount = state.playCount;
+    header.time = std::chrono::system_clock::now().time_since_epoch().count();
+    header.lastRun = lastRunCode(state.lastRun);
+    header.checksum = recordChecksum(header, filepath.data());
+    std::string buffer(reinterpret_cast<const char*>(&header), sizeof(header));
+    buffer += filepath;
+    return writeAll(fd, buffer.data(), buffer.size());
+}
+
+bool writeHeader(int fd) {
+    JournalHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, JOURNAL_MAGIC, sizeof(JOURNAL_MAGIC));
+    header.version = PlayJournal::FORMAT_VERSION;
+    return writeAll(fd, reinterpret_cast<const char*>(&header), sizeof(header));
+}
+
+// Reads the whole file; the journal stays small because it is compacted
+bool readFile(int fd, std::string& out) {
+    struct stat st;
+    if (fstat(fd, &st) != 0) return false;
+    out.resize(static_cast<size_t>(st.st_size));
+    size_t done = 0;
+    while (done < out.size()) {
+        ssize_t got = ::pread(fd, &out[done], out.size() - done, static_cast<off_t>(done));
+        if (got < 0 && errno == EINTR) continue;
+        if (got <= 0) break;
+        done += static_cast<size_t>(got);
+    }
+    out.resize(done);
+    return true;
+}
+
+} // namespace
+
+PlayJournal::PlayJournal(IConfigProvider& config) : config(config) {}
+
+PlayJournal::~PlayJournal() {
+    if (fd >= 0) ::close(fd);
+}
+
+std::string PlayJournal::getJournalPath() const {
+    return config.getBasePath() + "resources/play_journal.bin";
+}
+
+bool PlayJournal::load() {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (fd >= 0) return true;
+    const std::string path = getJournalPath();
+    std::error_code ec;
+    std::filesystem::create_directories(std::filesystem::path(path).parent_path(), ec);
+    fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+    if (fd < 0) {
+        std::cerr << "Failed to open play journal " << path << ": " << std::strerror(errno) << std::endl;
+        return false;
+    }
+
+    std::string data;
+    readFile(fd, data);
+    JournalHeader header;
+    if (data.size() < sizeof(header)) {
+        // New journal, or one torn while its header was written
+        if (ftruncate(fd, 0) != 0 || !writeHeader(fd)) {
+            std::cerr << "Failed to initialize play journal " << path << std::endl;
+        }
+        return true;
+    }
+    std::memcpy(&header, data.data(), sizeof(header));
+    if (std::memcmp(header.magic, JOURNAL_MAGIC, sizeof(JOURNAL_MAGIC)) != 0 || header.version != FORMAT_VERSION) {
+        std::cerr << "Ignoring play journal " << path << " with unknown format" << std::endl;
+        ::close(fd);
+        fd = -1;
+        return false;
+    }
+
+    size_t offset = sizeof(header);
+    while (offset + sizeof(RecordHeader) <= data.size()) {
+        RecordHeader record;
+        std::memcpy(&record, data.data() + offset, sizeof(record));
+        const char* recordPath = data.data() + offset + sizeof(record);
+        if (record.pathLength > MAX_PATH_LENGTH || record.pathLength > data.size() - offset - sizeof(record) ||
+            record.lastRun >= LAST_RUN_COUNT || record.checksum != recordChecksum(record, recordPath)) {
+            break;
+        }
+        PlayState& state = states[std::string(recordPath, record.pathLength)];
+        state.lastRun = LAST_RUN_NAMES[record.lastRun];
+        state.playCount = record.playCount;
+        ++recordCount;
+        offset += sizeof(record) + record.pathLength;
+    }
+    if (offset != data.size()) {
+        // A launch was being recorded when the process died; appends continue after the last good record
+        LOG_DEBUG("Dropping " << (data.size() - offset) << " trailing bytes from play journal");
+        if (ftruncate(fd, static_cast<off_t>(offset)) != 0) {
+            std::cerr << "Failed to truncate play journal " << path << std::endl;
+        }
+    }
+    LOG_DEBUG("Loaded play journal: " << states.size() << " tables from " << recordCount << " records");
+    if (needsCompaction()) compact();
+    return true;
+}
+
+bool PlayJournal::record(const std::string& filepath, const PlayState& state) {
+    std::lock_guard<std::mutex> lock(mutex);
+    states[filepath] = state;
+    if (fd < 0) return false;
+    if (!writeRecord(fd, filepath, state) || fdatasync(fd) != 0) {
+        std::cerr << "Failed to append to play journal " << getJournalPath() << ": " << std::strerror(errno) << std::endl;
+        return false;
+    }
+    ++recordCount;
+    if (needsCompaction()) compact();
+    return true;
+}
+
+size_t PlayJournal::apply(TableStore& tables) const {
+    std::lock_guard<std::mutex> lock(mutex);
+    size_t changed = 0;
+    for (const auto& [filepath, state] : states) {
+        size_t row = tables.find(filepath);
+        if (row == TableStore::npos) continue;
+        if (state.lastRun != tables.lastRun(row) || state.playCount != tables.playCount(row)) {
+            tables.setUserState(row, state.lastRun, state.playCount);
+            ++changed;
+        }
+    }
+    return changed;
+}
+
+bool PlayJournal::compact() {
+    const std::string path = getJournalPath();
+    const std::string tmpPath = path + ".tmp";
+    int tmp = ::open(tmpPath.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (tmp < 0) {
+        std::cerr << "Failed to open " << tmpPath << " for writing" << std::endl;
+        return false;
+    }
+    bool ok = writeHeader(tmp);
+    for (auto it = states.begin(); ok && it != states.end(); ++it) {
+        ok = writeRecord(tmp, it->first, it->second);
+    }
+    ok = ok && fsync(tmp) == 0;
+    ::close(tmp);
+    if (!ok) {
+        std::cerr << "Failed to write " << tmpPath << std::endl;
+        std::filesystem::remove(tmpPath);
+        return false;
+    }
+    std::error_code ec;
+    std::filesystem::rename(tmpPath, path, ec);
+    if (ec) {
+        std::cerr << "Failed to replace " << path << ": " << ec.message() << std::endl;
+        return false;
+    }
+
+    int compacted = ::open(path.c_str(), O_RDWR | O_APPEND | O_CLOEXEC);
+    if (compacted < 0) {
+        std::cerr << "Failed to reopen play journal " << path << std::endl;
+        return false;
+    }
+    ::close(fd);
+    fd = compacted;
+    LOG_DEBUG("Compacted play journal from " << recordCount << " to " << states.size() << " records");
+    recordCount = states.size();
+    return true;
+}
\ No newline at end of file
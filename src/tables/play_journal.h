@@ -0,0 +1,59 @@
+#ifndef PLAY_JOURNAL_H
+#define PLAY_JOURNAL_H
+
+#include "utils/logging.h"
+#include "config/iconfig_provider.h"
+#include "tables/table_store.h"
+#include "tables/user_state.h"
+#include <string>
+#include <unordered_map>
+#include <mutex>
+#include <cstdint>
+#include <cstddef>
+
+// Append-only log of play state (resources/play_journal.bin), kept apart from the table cache
+// so recording a launch is one small fsync'd write instead of a cache rewrite. Each record holds
+// a table's full state, so replaying keeps the last record per path; a torn record at the end
+// is dropped on load. Once most records are superseded the log is compacted to one per path.
+class PlayJournal {
+public:
+    // Constructor: Initializes with a config provider reference
+    PlayJournal(IConfigProvider& config);
+    ~PlayJournal();
+    PlayJournal(const PlayJournal&) = delete;
+    PlayJournal& operator=(const PlayJournal&) = delete;
+
+    // Replays the journal into memory and opens it for appending; compacts it if needed
+    // Returns: false if the journal could not be opened (play state then lives in the cache only)
+    bool load();
+
+    // Appends the new state of one table and syncs it to disk
+    // filepath: Table the state belongs to
+    // Returns: false if the record could not be written
+    bool record(const std::string& filepath, const PlayState& state);
+
+    // Overwrites lastRun and playCount of every row the journal has a state for; rows the
+    // journal doesn't know keep what the cache had, which covers installs from before the journal
+    // Returns: Number of rows that changed
+    size_t apply(TableStore& tables) const;
+
+    // Path of the journal file
+    std::string getJournalPath() const;
+
+    static const uint32_t FORMAT_VERSION = 1;
+
+private:
+    // Rewrites the journal with one record per path (temp file + rename) and reopens it
+    bool compact();
+
+    // True once most records in the file are superseded by later ones
+    bool needsCompaction() const { return recordCount > 256 && recordCount > 2 * states.size(); }
+
+    IConfigProvider& config; // Reference to configuration provider
+    mutable std::mutex mutex; // Guards everything below; record() runs on the UI thread
+    std::unordered_map<std::string, PlayState> states; // Latest state per table path
+    size_t recordCount = 0; // Records in the file, including superseded ones
+    int fd = -1; // Journal opened for appending
+};
+
+#endif // PLAY_JOURNAL_H
\ No newline at end of file
@@ -0,0 +1,348 @@
+#include "tables/search_index.h"
+#include "utils/logging.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <unordered_map>
+
+namespace {
+
+const char INDEX_MAGIC[8] = {'V', 'P', 'X', 'G', 'T', 'S', 'R', 'C'};
+const uint32_t INDEX_VERSION = 1;
+
+struct IndexHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t rowCount;
+    uint64_t keyFingerprint;
+    uint32_t trigramCount;
+    uint32_t postingCount;
+};
+
+static_assert(sizeof(IndexHeader) == 32, "IndexHeader layout is part of the file format");
+
+// Base letters for U+00C0..U+00FF and U+0100..U+017F. Digits stand for two-letter folds
+// (1 = ij, 2 = oe, 3 = ae, 4 = th, 5 = ss); '*' keeps the character (multiplication and division signs).
+const char LATIN1_FOLD[] = "aaaaaa3ceeeeiiii" "dnooooo*ouuuuy45" "aaaaaa3ceeeeiiii" "dnooooo*ouuuuy4y";
+const char LATIN_EXT_A_FOLD[] = "aaaaaaccccccccddddeeeeeeeeeegggggggghhhhiiiiiiiiii11jjkkkllllllllllnnnnnnnnnoooooo22rrrrrrssssssssttttttuuuuuuuuuuuuwwyyyzzzzzzs";
+static_assert(sizeof(LATIN1_FOLD) == 0x40 + 1, "One entry per code point from U+00C0");
+static_assert(sizeof(LATIN_EXT_A_FOLD) == 0x80 + 1, "One entry per code point from U+0100");
+
+void appendUtf8(uint32_t cp, std::string& out) {
+    if (cp < 0x80) {
+        out += static_cast<char>(cp);
+    } else if (cp < 0x800) {
+        out += static_cast<char>(0xC0 | (cp >> 6));
+        out += static_cast<char>(0x80 | (cp & 0x3F));
+    } else if (cp < 0x10000) {
+        out += static_cast<char>(0xE0 | (cp >> 12));
+        out += static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+        out += static_cast<char>(0x80 | (cp & 0x3F));
+    } else {
+        out += static_cast<char>(0xF0 | (cp >> 18));
+        out += static_cast<char>(0x80 | ((cp >> 12) & 0x3F));
+        out += static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+        out += static_cast<char>(0x80 | (cp & 0x3F));
+    }
+}
+
+void appendLatinFold(char code, uint32_t cp, std::string& out) {
+    switch (code) {
+        case '1': out += "ij"; break;
+        case '2': out += "oe"; break;
+        case '3': out += "ae"; break;
+        case '4': out += "th"; break;
+        case '5': out += "ss"; break;
+        case '*': appendUtf8(cp, out); break;
+        default: out += code; break;
+    }
+}
+
+// Greek letters with tonos map to their plain lowercase letter
+uint32_t foldGreek(uint32_t cp) {
+    switch (cp) {
+        case 0x386: case 0x3AC: return 0x3B1; // alpha
+        case 0x388: case 0x3AD: return 0x3B5; // epsilon
+        case 0x389: case 0x3AE: return 0x3B7; // eta
+        case 0x38A: case 0x3AF: return 0x3B9; // iota
+        case 0x38C: case 0x3CC: return 0x3BF; // omicron
+        case 0x38E: case 0x3CD: return 0x3C5; // upsilon
+        case 0x38F: case 0x3CE: return 0x3C9; // omega
+        case 0x3C2: return 0x3C3;             // final sigma
+        default: break;
+    }
+    if (cp >= 0x391 && cp <= 0x3A9) return cp + 0x20;
+    return cp;
+}
+
+uint32_t foldCyrillic(uint32_t cp) {
+    if (cp == 0x401 || cp == 0x451) return 0x435; // yo -> ie
+    if (cp >= 0x400 && cp <= 0x40F) return cp + 0x50;
+    if (cp >= 0x410 && cp <= 0x42F) return cp + 0x20;
+    return cp;
+}
+
+void appendFolded(uint32_t cp, std::string& out) {
+    if (cp >= 0x300 && cp <= 0x36F) return; // Combining diacritical marks
+    if (cp >= 0xFF01 && cp <= 0xFF5E) cp -= 0xFEE0; // Fullwidth ASCII
+    if (cp < 0x80) {
+        if (cp < 0x20 || cp == 0x7F) return;
+        out += static_cast<char>(cp >= 'A' && cp <= 'Z' ? cp + ('a' - 'A') : cp);
+    } else if (cp >= 0xC0 && cp < 0x100) {
+        appendLatinFold(LATIN1_FOLD[cp - 0xC0], cp, out);
+    } else if (cp >= 0x100 && cp < 0x180) {
+        appendLatinFold(LATIN_EXT_A_FOLD[cp - 0x100], cp, out);
+    } else if (cp >= 0x370 && cp < 0x400) {
+        appendUtf8(foldGreek(cp), out);
+    } else if (cp >= 0x400 && cp < 0x460) {
+        appendUtf8(foldCyrillic(cp), out);
+    } else {
+        appendUtf8(cp, out);
+    }
+}
+
+inline uint32_t packTrigram(std::string_view key, size_t i) {
+    return (static_cast<uint32_t>(static_cast<unsigned char>(key[i])) << 16) |
+           (static_cast<uint32_t>(static_cast<unsigned char>(key[i + 1])) << 8) |
+           static_cast<uint32_t>(static_cast<unsigned char>(key[i + 2]));
+}
+
+inline bool spansSeparator(std::string_view key, size_t i) {
+    return key[i] == SearchIndex::KEY_SEPARATOR || key[i + 1] == SearchIndex::KEY_SEPARATOR ||
+           key[i + 2] == SearchIndex::KEY_SEPARATOR;
+}
+
+} // namespace
+
+std::string SearchIndex::fold(const std::string& text) {
+    std::string out;
+    out.reserve(text.size());
+    const size_t n = text.size();
+    for (size_t i = 0; i < n;) {
+        unsigned char c = static_cast<unsigned char>(text[i]);
+        if (c < 0x80) {
+            appendFolded(c, out);
+            ++i;
+            continue;
+        }
+        size_t len = c >= 0xC2 && c <= 0xDF ? 2 : c >= 0xE0 && c <= 0xEF ? 3 : c >= 0xF0 && c <= 0xF4 ? 4 : 0;
+        bool valid = len > 0 && i + len <= n;
+        for (size_t k = 1; valid && k < len; ++k) {
+            valid = (static_cast<unsigned char>(text[i + k]) & 0xC0) == 0x80;
+        }
+        if (!valid) {
+            out += static_cast<char>(c);
+            ++i;
+            continue;
+        }
+        uint32_t cp = c & (0x7F >> len);
+        for (size_t k = 1; k < len; ++k) {
+            cp = (cp << 6) | (static_cast<unsigned char>(text[i + k]) & 0x3F);
+        }
+        appendFolded(cp, out);
+        i += len;
+    }
+    return out;
+}
+
+std::string SearchIndex::makeSearchKey(const std::string& name, const std::string& filename) {
+    return fold(name) + KEY_SEPARATOR + fold(filename);
+}
+
+std::string SearchIndex::makeFuzzyKey(const std::string& author, const std::string& gameName) {
+    return fold(author) + KEY_SEPARATOR + fold(gameName);
+}
+
+uint64_t SearchIndex::charMask(std::string_view folded) {
+    uint64_t mask = 0;
+    for (unsigned char c : folded) {
+        if (c >= 'a' && c <= 'z') mask |= 1ull << (c - 'a');
+        else if (c >= '0' && c <= '9') mask |= 1ull << (26 + c - '0');
+        else if (c != ' ' && c != static_cast<unsigned char>(KEY_SEPARATOR)) mask |= 1ull << (36 + c % 28);
+    }
+    return mask;
+}
+
+void SearchIndex::buildCharMasks(const TableStore& tables) {
+    charMasks.resize(tables.size());
+    for (size_t row = 0; row < tables.size(); ++row) {
+        charMasks[row] = charMask(tables.searchKey(row)) | charMask(tables.fuzzyKey(row));
+    }
+}
+
+void SearchIndex::build(const TableStore& tables) {
+    // Rows are visited in order, so every list comes out ascending and a repeated trigram
+    // within one key only needs a check against the last row appended
+    std::unordered_map<uint32_t, std::vector<uint32_t>> lists;
+    for (size_t row = 0; row < tables.size(); ++row) {
+        std::string_view key = tables.searchKey(row);
+        for (size_t i = 0; i + 2 < key.size(); ++i) {
+            if (spansSeparator(key, i)) continue;
+            auto& list = lists[packTrigram(key, i)];
+            if (list.empty() || list.back() != row) list.push_back(static_cast<uint32_t>(row));
+        }
+    }
+
+    trigrams.clear();
+    trigrams.reserve(lists.size());
+    for (const auto& [trigram, list] : lists) trigrams.push_back(trigram);
+    std::sort(trigrams.begin(), trigrams.end());
+
+    offsets.assign(1, 0);
+    offsets.reserve(trigrams.size() + 1);
+    postingData.clear();
+    for (uint32_t trigram : trigrams) {
+        const auto& list = lists[trigram];
+        postingData.insert(postingData.end(), list.begin(), list.end());
+        offsets.push_back(static_cast<uint32_t>(postingData.size()));
+    }
+    rowCount = tables.size();
+    keyFingerprint = fingerprint(tables);
+    buildCharMasks(tables);
+    LOG_DEBUG("Search index: " << trigrams.size() << " trigrams, " << postingData.size() << " postings for " << rowCount << " tables");
+}
+
+const uint32_t* SearchIndex::postings(uint32_t trigram, size_t& count) const {
+    auto it = std::lower_bound(trigrams.begin(), trigrams.end(), trigram);
+    if (it == trigrams.end() || *it != trigram) return nullptr;
+    size_t i = static_cast<size_t>(it - trigrams.begin());
+    count = offsets[i + 1] - offsets[i];
+    return postingData.data() + offsets[i];
+}
+
+void SearchIndex::find(const TableStore& tables, const std::string& foldedQuery, std::vector<size_t>& rows) const {
+    rows.clear();
+    if (foldedQuery.size() < 3 || rowCount != tables.size()) {
+        // Too short for a trigram (or the index is out of date): check every key
+        for (size_t i = 0; i < tables.size(); ++i) {
+            if (tables.searchKey(i).find(foldedQuery) != std::string_view::npos) rows.push_back(i);
+        }
+        return;
+    }
+
+    std::vector<uint32_t> queryTrigrams;
+    for (size_t i = 0; i + 2 < foldedQuery.size(); ++i) {
+        queryTrigrams.push_back(packTrigram(foldedQuery, i));
+    }
+    std::sort(queryTrigrams.begin(), queryTrigrams.end());
+    queryTrigrams.erase(std::unique(queryTrigrams.begin(), queryTrigrams.end()), queryTrigrams.end());
+
+    std::vector<std::pair<const uint32_t*, size_t>> lists;
+    for (uint32_t trigram : queryTrigrams) {
+        size_t count = 0;
+        const uint32_t* list = postings(trigram, count);
+        if (!list) return; // Some trigram occurs in no key
+        lists.emplace_back(list, count);
+    }
+    // Intersect from the shortest list so the candidate set only ever shrinks
+    std::sort(lists.begin(), lists.end(), [](const auto& a, const auto& b) { return a.second < b.second; });
+
+    std::vector<uint32_t> candidates(lists[0].first, lists[0].first + lists[0].second);
+    for (size_t l = 1; l < lists.size() && !candidates.empty(); ++l) {
+        const uint32_t* pos = lists[l].first;
+        const uint32_t* end = lists[l].first + lists[l].second;
+        size_t kept = 0;
+        for (uint32_t row : candidates) {
+            pos = std::lower_bound(pos, end, row);
+            if (pos == end) break;
+            if (*pos == row) candidates[kept++] = row;
+        }
+        candidates.resize(kept);
+    }
+
+    // Sharing all trigrams does not guarantee they are adjacent in the right order
+    for (uint32_t row : candidates) {
+        if (tables.searchKey(row).find(foldedQuery) != std::string_view::npos) rows.push_back(row);
+    }
+}
+
+uint64_t SearchIndex::fingerprint(const TableStore& tables) {
+    uint64_t hash = 14695981039346656037ull; // FNV-1a
+    for (size_t row = 0; row < tables.size(); ++row) {
+        for (unsigned char c : tables.searchKey(row)) {
+            hash = (hash ^ c) * 1099511628211ull;
+        }
+        hash = (hash ^ '\n') * 1099511628211ull;
+    }
+    return hash;
+}
+
+bool SearchIndex::save(const std::string& path) const {
+    IndexHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, INDEX_MAGIC, sizeof(INDEX_MAGIC));
+    header.version = INDEX_VERSION;
+    header.rowCount = static_cast<uint32_t>(rowCount);
+    header.keyFingerprint = keyFingerprint;
+    header.trigramCount = static_cast<uint32_t>(trigrams.size());
+    header.postingCount = static_cast<uint32_t>(postingData.size());
+
+    const std::string tmpPath = path + ".tmp";
+    {
+        std::ofstream file(tmpPath, std::ios::binary | std::ios::trunc);
+        if (!file) {
+            std::cerr << "Failed to write search index: " << tmpPath << std::endl;
+            return false;
+        }
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        file.write(reinterpret_cast<const char*>(trigrams.data()), trigrams.size() * sizeof(uint32_t));
+        file.write(reinterpret_cast<const char*>(offsets.data()), offsets.size() * sizeof(uint32_t));
+        file.write(reinterpret_cast<const char*>(postingData.data()), postingData.size() * sizeof(uint32_t));
+        if (!file) {
+            std::cerr << "Failed to write search index: " << tmpPath << std::endl;
+            return false;
+        }
+    }
+    if (std::rename(tmpPath.c_str(), path.c_str()) != 0) {
+        std::cerr << "Failed to replace search index: " << path << std::endl;
+        return false;
+    }
+    return true;
+}
+
+bool SearchIndex::load(const std::string& path, const TableStore& tables) {
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    if (!file) return false;
+    const uint64_t fileSize = static_cast<uint64_t>(file.tellg());
+    file.seekg(0);
+    IndexHeader header;
+    if (!file.read(reinterpret_cast<char*>(&header), sizeof(header)) ||
+        std::memcmp(header.magic, INDEX_MAGIC, sizeof(INDEX_MAGIC)) != 0 || header.version != INDEX_VERSION) {
+        LOG_DEBUG("Search index " << path << " has unknown format");
+        return false;
+    }
+    uint64_t expected = fingerprint(tables);
+    if (header.rowCount != tables.size() || header.keyFingerprint != expected) {
+        LOG_DEBUG("Search index " << path << " does not match the cached tables");
+        return false;
+    }
+    // The counts come from the file, so check they fit before allocating anything for them
+    const uint64_t arrayWords = 2 * static_cast<uint64_t>(header.trigramCount) + 1 + header.postingCount;
+    if (fileSize < sizeof(header) + arrayWords * sizeof(uint32_t)) {
+        LOG_DEBUG("Search index " << path << " is truncated");
+        return false;
+    }
+
+    std::vector<uint32_t> newTrigrams(header.trigramCount);
+    std::vector<uint32_t> newOffsets(static_cast<size_t>(header.trigramCount) + 1);
+    std::vector<uint32_t> newPostings(header.postingCount);
+    file.read(reinterpret_cast<char*>(newTrigrams.data()), newTrigrams.size() * sizeof(uint32_t));
+    file.read(reinterpret_cast<char*>(newOffsets.data()), newOffsets.size() * sizeof(uint32_t));
+    file.read(reinterpret_cast<char*>(newPostings.data()), newPostings.size() * sizeof(uint32_t));
+    if (!file || newOffsets.front() != 0 || newOffsets.back() != header.postingCount ||
+        !std::is_sorted(newOffsets.begin(), newOffsets.end()) ||
+        std::any_of(newPostings.begin(), newPostings.end(), [&](uint32_t row) { return row >= header.rowCount; })) {
+        LOG_DEBUG("Search index " << path << " is corrupt");
+        return false;
+    }
+
+    trigrams.swap(newTrigrams);
+    offsets.swap(newOffsets);
+    postingData.swap(newPostings);
+    rowCount = header.rowCount;
+    keyFingerprint = expected;
+    buildCharMasks(tables);
+    LOG_DEBUG("Loaded search index: " << trigrams.size() << " trigrams for " << rowCount << " tables");
+    return true;
+}
\ No newline at end of file
@@ -0,0 +1,72 @@
+#ifndef SEARCH_INDEX_H
+#define SEARCH_INDEX_H
+
+#include "tables/table_store.h"
+#include <string>
+#include <string_view>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+// Trigram inverted index over TableStore::searchKey(). Every distinct 3-byte sequence of the
+// folded keys maps to the ascending list of rows containing it, so a substring query only
+// verifies the rows found in all of its trigrams' posting lists instead of scanning every key.
+class SearchIndex {
+public:
+    // Folds text for matching: ASCII and Latin/Greek/Cyrillic letters are lowercased, accents
+    // are stripped (é -> e, ß -> ss, Æ -> ae), combining marks and control characters dropped
+    // text: UTF-8 input; invalid bytes are copied through unchanged
+    static std::string fold(const std::string& text);
+
+    // Search keys of a row: the folded name and filename, and for fuzzy matching the folded
+    // author and ROM name, each pair joined by KEY_SEPARATOR, which fold() never produces,
+    // so a match can't span two fields
+    static std::string makeSearchKey(const std::string& name, const std::string& filename);
+    static std::string makeFuzzyKey(const std::string& author, const std::string& gameName);
+
+    // Character set of a folded string as a bitmask, for cheap "can this row match at all" tests:
+    // a-z and 0-9 get a bit each, other bytes share the remaining bits, spaces are ignored
+    static uint64_t charMask(std::string_view folded);
+
+    // Rebuilds the index for the search keys of tables
+    void build(const TableStore& tables);
+
+    // Finds the rows whose searchKey contains a folded query
+    // tables: Rows the index was built for
+    // foldedQuery: Query passed through fold(); empty matches every row
+    // rows: Receives matching row indices in ascending order
+    void find(const TableStore& tables, const std::string& foldedQuery, std::vector<size_t>& rows) const;
+
+    // Writes the index next to the table cache (temp file + rename)
+    // Returns: false if the file could not be written
+    bool save(const std::string& path) const;
+
+    // Reads an index saved for exactly these rows; a missing, corrupt or outdated file is ignored
+    // tables: Rows the index must match, compared via a fingerprint of their search keys
+    // Returns: true if the index was loaded and can be used for tables
+    bool load(const std::string& path, const TableStore& tables);
+
+    size_t getRowCount() const { return rowCount; }
+
+    // charMask() of each row's searchKey and fuzzyKey combined, contiguous for vectorized scans
+    const std::vector<uint64_t>& getCharMasks() const { return charMasks; }
+
+    static const char KEY_SEPARATOR = '\x1f';
+
+private:
+    static uint64_t fingerprint(const TableStore& tables);
+
+    void buildCharMasks(const TableStore& tables);
+
+    // Posting list of one trigram, or nullptr if no row contains it
+    const uint32_t* postings(uint32_t trigram, size_t& count) const;
+
+    size_t rowCount = 0;
+    uint64_t keyFingerprint = 0;
+    std::vector<uint32_t> trigrams; // Sorted distinct trigrams, packed as (b0 << 16) | (b1 << 8) | b2
+    std::vector<uint32_t> offsets;  // Posting list of trigrams[i] is postingData[offsets[i], offsets[i + 1])
+    std::vector<uint32_t> postingData; // Ascending row indices
+    std::vector<uint64_t> charMasks; // Per row; cheap to derive, so not persisted
+};
+
+#endif // SEARCH_INDEX_H
\ No newline at end of file
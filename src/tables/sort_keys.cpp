@@ -0,0 +1,114 @@
+#include "tables/sort_keys.h"
+#include "tables/search_index.h"
+#include <algorithm>
+#include <numeric>
+
+namespace {
+
+// One field of a "first<sep>second" search key
+inline std::string_view keyField(std::string_view key) {
+    return key.substr(0, key.find(SearchIndex::KEY_SEPARATOR));
+}
+
+} // namespace
+
+const std::vector<uint64_t>& SortKeys::get(const TableStore& tables, int column, uint64_t dataVersion) {
+    if (column < 0 || column >= COLUMN_COUNT) {
+        noKeys.assign(tables.size(), 0);
+        return noKeys;
+    }
+    if (!built[column] || builtVersion[column] != dataVersion || keys[column].size() != tables.size()) {
+        build(tables, column, keys[column]);
+        built[column] = true;
+        builtVersion[column] = dataVersion;
+    }
+    return keys[column];
+}
+
+long SortKeys::parseYear(std::string_view year) {
+    long value = -1;
+    for (char c : year) {
+        if (c >= '0' && c <= '9') {
+            value = (value < 0 ? 0 : value * 10) + (c - '0');
+            if (value > 99999) break;
+        } else if (value >= 0) {
+            break;
+        }
+    }
+    return value;
+}
+
+uint64_t SortKeys::parseVersion(std::string_view version) {
+    size_t pos = version.find_first_of("0123456789");
+    if (pos == std::string_view::npos) return MISSING;
+    uint64_t packed = 0;
+    int parts = 0;
+    while (parts < 4) {
+        uint64_t part = 0;
+        while (pos < version.size() && version[pos] >= '0' && version[pos] <= '9') {
+            part = std::min<uint64_t>(part * 10 + (version[pos] - '0'), 0xFFFE);
+            ++pos;
+        }
+        packed = (packed << 16) | part;
+        ++parts;
+        // Only "N.N" continues the version; a suffix like "b" or " beta" ends it
+        if (pos + 1 >= version.size() || version[pos] != '.' || version[pos + 1] < '0' || version[pos + 1] > '9') break;
+        ++pos;
+    }
+    return packed << (16 * (4 - parts));
+}
+
+void SortKeys::build(const TableStore& tables, int column, std::vector<uint64_t>& out) const {
+    out.resize(tables.size());
+    switch (column) {
+        case Year:
+            for (size_t i = 0; i < tables.size(); ++i) {
+                long year = parseYear(tables.year(i));
+                out[i] = year < 0 ? MISSING : static_cast<uint64_t>(year);
+            }
+            break;
+        case Author: rank(tables, out, [&tables](size_t i) { return keyField(tables.fuzzyKey(i)); }); break;
+        case Name: rank(tables, out, [&tables](size_t i) { return keyField(tables.searchKey(i)); }); break;
+        case Version:
+            for (size_t i = 0; i < tables.size(); ++i) out[i] = parseVersion(tables.version(i));
+            break;
+        case ExtraFiles: statusKeys(tables, out, STATUS_SIDECARS); break;
+        case Rom:
+            // Found ROMs by name, tables without one last
+            rank(tables, out, [&tables](size_t i) {
+                return (tables.status(i) & STATUS_ROM) ? tables.gameName(i) : std::string_view();
+            });
+            break;
+        case UltraDmd: statusKeys(tables, out, STATUS_ULTRADMD); break;
+        case AltSound: statusKeys(tables, out, STATUS_ALTSOUND); break;
+        case AltColor: statusKeys(tables, out, STATUS_ALTCOLOR); break;
+        case PupPack: statusKeys(tables, out, STATUS_PUPPACK); break;
+        case Music: statusKeys(tables, out, STATUS_MUSIC); break;
+        case Images: statusKeys(tables, out, STATUS_IMAGES); break;
+        case Videos: statusKeys(tables, out, STATUS_VIDEOS); break;
+        case PlayCount:
+            for (size_t i = 0; i < tables.size(); ++i) out[i] = static_cast<uint64_t>(std::max(tables.playCount(i), 0));
+            break;
+    }
+}
+
+void SortKeys::statusKeys(const TableStore& tables, std::vector<uint64_t>& out, uint32_t bits) {
+    for (size_t i = 0; i < tables.size(); ++i) out[i] = tables.status(i) & bits;
+}
+
+template <typename TextOf>
+void SortKeys::rank(const TableStore& tables, std::vector<uint64_t>& out, TextOf textOf) {
+    std::vector<std::string_view> texts(tables.size());
+    for (size_t i = 0; i < tables.size(); ++i) texts[i] = textOf(i);
+
+    std::vector<uint32_t> byText(tables.size());
+    std::iota(byText.begin(), byText.end(), 0);
+    std::sort(byText.begin(), byText.end(), [&texts](uint32_t a, uint32_t b) { return texts[a] < texts[b]; });
+
+    uint64_t current = 0;
+    for (size_t n = 0; n < byText.size(); ++n) {
+        if (n > 0 && texts[byText[n]] != texts[byText[n - 1]]) ++current;
+        // Rows without the text go last, like a missing year
+        out[byText[n]] = texts[byText[n]].empty() ? MISSING : current;
+    }
+}
\ No newline at end of file
@@ -0,0 +1,55 @@
+#ifndef SORT_KEYS_H
+#define SORT_KEYS_H
+
+#include "tables/table_store.h"
+#include <vector>
+#include <string_view>
+#include <cstdint>
+
+// Typed per-row sort keys for the launcher columns: the year and play count as numbers, the
+// version as a packed semantic version, status columns as their TableStatus bits and text
+// columns as the rank of their folded value. A sort then compares integers instead of
+// strings. Keys of a column are built the first time it is sorted on and kept until the rows change.
+class SortKeys {
+public:
+    // Launcher columns, in TableView order
+    enum Column {
+        Year, Author, Name, Version, ExtraFiles, Rom, UltraDmd, AltSound, AltColor, PupPack, Music,
+        Images, Videos, PlayCount, COLUMN_COUNT
+    };
+
+    // Key of a row that has no value for the column; TableFilter keeps such rows last in either direction
+    static const uint64_t MISSING = UINT64_MAX;
+
+    // Keys of one column for every row, in row order
+    // tables: Authoritative table list
+    // column: Column to sort on; out of range columns get all-zero keys
+    // dataVersion: Changes whenever tables (or any row in it) changes
+    const std::vector<uint64_t>& get(const TableStore& tables, int column, uint64_t dataVersion);
+
+    // First number in a free-form year ("1994", "c. 1980", "1979-1980")
+    // Returns: -1 if the text holds no digits
+    static long parseYear(std::string_view year);
+
+    // Packs the first four dot-separated numbers of a version ("v1.2.10b" -> 1.2.10.0) into
+    // 16 bits each, so "1.10" orders after "1.9"
+    // Returns: MISSING if the text holds no digits
+    static uint64_t parseVersion(std::string_view version);
+
+private:
+    void build(const TableStore& tables, int column, std::vector<uint64_t>& keys) const;
+
+    // Sets each key to the row's TableStatus bits within a column's group
+    static void statusKeys(const TableStore& tables, std::vector<uint64_t>& keys, uint32_t bits);
+
+    // Sets each key to the rank of the row's text among all rows; equal texts share a rank
+    template <typename TextOf>
+    static void rank(const TableStore& tables, std::vector<uint64_t>& keys, TextOf textOf);
+
+    std::vector<uint64_t> keys[COLUMN_COUNT];
+    bool built[COLUMN_COUNT] = {};
+    uint64_t builtVersion[COLUMN_COUNT] = {};
+    std::vector<uint64_t> noKeys;
+};
+
+#endif // SORT_KEYS_H
\ No newline at end of file
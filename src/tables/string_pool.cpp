@@ -0,0 +1,48 @@
+#include "tables/string_pool.h"
+
+uint32_t StringPool::intern(std::string_view value) {
+    if (value.empty()) return 0;
+    // Keep the table at most half full so probe runs stay short
+    if ((size() + 1) * 2 > slots.size()) grow();
+
+    const size_t mask = slots.size() - 1;
+    for (size_t slot = hash(value) & mask;; slot = (slot + 1) & mask) {
+        uint32_t id = slots[slot];
+        if (id == EMPTY_SLOT) {
+            id = static_cast<uint32_t>(size());
+            data.append(value.data(), value.size());
+            offsets.push_back(static_cast<uint32_t>(data.size()));
+            slots[slot] = id;
+            return id;
+        }
+        if (get(id) == value) return id;
+    }
+}
+
+void StringPool::clear() {
+    data.clear();
+    offsets.assign(2, 0); // Id 0: the empty string
+    slots.assign(16, EMPTY_SLOT);
+}
+
+size_t StringPool::memoryUsage() const {
+    return data.capacity() + offsets.capacity() * sizeof(uint32_t) + slots.capacity() * sizeof(uint32_t);
+}
+
+uint64_t StringPool::hash(std::string_view value) {
+    uint64_t h = 14695981039346656037ull; // FNV-1a
+    for (unsigned char c : value) {
+        h = (h ^ c) * 1099511628211ull;
+    }
+    return h ^ (h >> 32);
+}
+
+void StringPool::grow() {
+    slots.assign(slots.size() * 2, EMPTY_SLOT);
+    const size_t mask = slots.size() - 1;
+    for (uint32_t id = 1; id < size(); ++id) {
+        size_t slot = hash(get(id)) & mask;
+        while (slots[slot] != EMPTY_SLOT) slot = (slot + 1) & mask;
+        slots[slot] = id;
+    }
+}
\ No newline at end of file
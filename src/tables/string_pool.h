@@ -0,0 +1,44 @@
+#ifndef STRING_POOL_H
+#define STRING_POOL_H
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+// Interned strings stored back to back in one buffer: equal values share one id, so a column
+// of authors or years costs 4 bytes per row plus each distinct value once. Id 0 is always the
+// empty string, and ids stay valid until clear().
+class StringPool {
+public:
+    StringPool() { clear(); }
+
+    // Returns: Id of value, adding it if it is not in the pool yet
+    uint32_t intern(std::string_view value);
+
+    std::string_view get(uint32_t id) const {
+        return std::string_view(data.data() + offsets[id], offsets[id + 1] - offsets[id]);
+    }
+
+    // Number of distinct values, including the empty string
+    size_t size() const { return offsets.size() - 1; }
+
+    void clear();
+
+    // Bytes allocated for values, offsets and the lookup table
+    size_t memoryUsage() const;
+
+private:
+    static uint64_t hash(std::string_view value);
+
+    // Doubles the lookup table and re-inserts every id
+    void grow();
+
+    std::string data;
+    std::vector<uint32_t> offsets; // Value of id spans data[offsets[id], offsets[id + 1])
+    std::vector<uint32_t> slots;   // Open addressing table of ids; EMPTY_SLOT when free
+    static constexpr uint32_t EMPTY_SLOT = UINT32_MAX;
+};
+
+#endif // STRING_POOL_H
\ No newline at end of file
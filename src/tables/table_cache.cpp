@@ -0,0 +1,436 @@
+#include "tables/table_cache.h"
+#include <json.hpp>
+#include <chrono>
+#include <cstddef>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <unordered_map>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using json = nlohmann::json;
+
+namespace {
+
+const char CACHE_MAGIC[8] = {'V', 'P', 'X', 'G', 'T', 'I', 'D', 'X'};
+
+// Every string column of TableEntry, in on-disk order. Appending is a format change: bump FORMAT_VERSION.
+std::string TableEntry::* const STRING_FIELDS[] = {
+    &TableEntry::filepath, &TableEntry::filename, &TableEntry::year, &TableEntry::author,
+    &TableEntry::name, &TableEntry::version, &TableEntry::gameName, &TableEntry::lastRun,
+};
+const size_t STRING_FIELD_COUNT = sizeof(STRING_FIELDS) / sizeof(STRING_FIELDS[0]);
+
+// Loader, updater and manager each own a TableCache and may save from different threads
+std::mutex saveMutex;
+
+const uint32_t ROW_VBS_MODIFIED = 1u << 0;
+const uint32_t ROW_INI_MODIFIED = 1u << 1;
+const uint32_t ROW_REQUIRES_PINMAME = 1u << 2;
+
+struct CacheHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t rowCount;
+    int64_t lastUpdated;   // ns since epoch
+    uint64_t rowsOffset;
+    uint64_t stringsOffset;
+    uint64_t stringsSize;
+    uint32_t rowSize;      // sizeof(CacheRow)
+    uint32_t probeSettings; // probeSettingsHash() of the config the rows were probed with
+};
+
+struct StringRef {
+    uint32_t offset; // Into the string table
+    uint32_t length;
+};
+
+struct CacheRow {
+    StringRef strings[STRING_FIELD_COUNT];
+    uint64_t size;
+    int64_t mtime;
+    uint64_t inode;
+    int32_t playCount;
+    uint32_t flags;
+    // Script comparison state
+    uint64_t scriptSize;
+    int64_t scriptMtime;
+    uint64_t scriptInode;
+    uint64_t scriptHash;
+    uint64_t vbsSize;
+    int64_t vbsMtime;
+    uint64_t vbsInode;
+    uint64_t vbsHash;
+    // INI comparison state
+    uint64_t iniSize;
+    int64_t iniMtime;
+    uint64_t iniInode;
+    uint64_t iniBaseSize;
+    int64_t iniBaseMtime;
+    uint64_t iniBaseInode;
+    StringRef iniOverrides; // Newline-separated "Section/Key" names
+    uint32_t status; // TableStatus bits
+    uint32_t padding;
+};
+
+static_assert(sizeof(CacheHeader) == 56, "CacheHeader layout is part of the file format");
+static_assert(sizeof(CacheRow) % 8 == 0, "CacheRow must keep rows 8-byte aligned");
+
+// Read-only mapping that unmaps itself
+struct MappedFile {
+    const uint8_t* data = nullptr;
+    size_t size = 0;
+    explicit MappedFile(const std::string& path) {
+        int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0) return;
+        struct stat st;
+        if (fstat(fd, &st) == 0 && st.st_size > 0) {
+            void* mapped = mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+            if (mapped != MAP_FAILED) {
+                data = static_cast<const uint8_t*>(mapped);
+                size = static_cast<size_t>(st.st_size);
+            }
+        }
+        ::close(fd);
+    }
+    ~MappedFile() {
+        if (data) munmap(const_cast<uint8_t*>(data), size);
+    }
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+};
+
+// Hashes the settings that decide where updateChunk() looks for media, sidecars and ROMs.
+// Rows probed under different settings are no longer trusted by the launcher.
+uint32_t probeSettingsHash(const IConfigProvider& config) {
+    const std::string values[] = {
+        config.getRomPath(), config.getAltSoundPath(), config.getAltColorPath(), config.getPupPackPath(),
+        config.getMusicPath(), config.getWheelImage(), config.getTableImage(), config.getBackglassImage(),
+        config.getMarqueeImage(), config.getTableVideo(), config.getBackglassVideo(), config.getDmdVideo(),
+    };
+    uint32_t hash = 2166136261u; // FNV-1a
+    for (const auto& value : values) {
+        for (unsigned char c : value) {
+            hash = (hash ^ c) * 16777619u;
+        }
+        hash *= 16777619u; // Field separator: moving a character between fields changes the hash
+    }
+    return hash == 0 ? 1 : hash;
+}
+
+// TableStatus bits of a row exported before the status bits, from its display strings
+// legacy: extraFiles, rom, udmd, alts, altc, pup, music, images, videos
+uint32_t legacyStatus(const std::string* legacy) {
+    const std::string& extraFiles = legacy[0];
+    const std::string& images = legacy[7];
+    const std::string& videos = legacy[8];
+    uint32_t status = 0;
+    if (extraFiles.find("INI") != std::string::npos) status |= STATUS_INI;
+    if (extraFiles.find("VBS") != std::string::npos) status |= STATUS_VBS;
+    if (extraFiles.find("B2S") != std::string::npos) status |= STATUS_B2S;
+    if (!legacy[1].empty()) status |= STATUS_ROM;
+    if (!legacy[2].empty()) status |= STATUS_ULTRADMD;
+    if (!legacy[3].empty()) status |= STATUS_ALTSOUND;
+    if (!legacy[4].empty()) status |= STATUS_ALTCOLOR;
+    if (!legacy[5].empty()) status |= STATUS_PUPPACK;
+    if (!legacy[6].empty()) status |= STATUS_MUSIC;
+    if (images.find("Wheel") != std::string::npos) status |= STATUS_WHEEL_IMAGE;
+    if (images.find("Table") != std::string::npos) status |= STATUS_TABLE_IMAGE;
+    if (images.find("B2S") != std::string::npos) status |= STATUS_BACKGLASS_IMAGE;
+    if (images.find("Marquee") != std::string::npos) status |= STATUS_MARQUEE_IMAGE;
+    if (videos.find("Table") != std::string::npos) status |= STATUS_TABLE_VIDEO;
+    if (videos.find("B2S") != std::string::npos) status |= STATUS_BACKGLASS_VIDEO;
+    if (videos.find("DMD") != std::string::npos) status |= STATUS_DMD_VIDEO;
+    return status;
+}
+
+} // namespace
+
+TableCache::TableCache(IConfigProvider& config) : config(config) {}
+
+std::string TableCache::getCachePath() const {
+    return config.getBasePath() + "resources/tables_index.bin";
+}
+
+std::string TableCache::getSearchIndexPath() const {
+    return config.getBasePath() + "resources/tables_search.bin";
+}
+
+std::string TableCache::getJsonPath() const {
+    return config.getBasePath() + "resources/tables_index.json";
+}
+
+bool TableCache::load(std::vector<TableEntry>& tables, long long& lastUpdated) const {
+    const std::string path = getCachePath();
+    if (!std::filesystem::exists(path)) {
+        return loadLegacyJson(tables, lastUpdated);
+    }
+    MappedFile file(path);
+    if (!file.data || file.size < sizeof(CacheHeader)) {
+        LOG_DEBUG("Could not map cache: " << path);
+        return false;
+    }
+
+    // Any other version is rebuilt from scratch by the loader
+    CacheHeader header;
+    std::memcpy(&header, file.data, sizeof(CacheHeader));
+    if (std::memcmp(header.magic, CACHE_MAGIC, sizeof(CACHE_MAGIC)) != 0 || header.version != FORMAT_VERSION) {
+        LOG_DEBUG("Cache " << path << " has unknown format or version " << header.version);
+        return false;
+    }
+    if (header.rowSize != sizeof(CacheRow)) {
+        LOG_DEBUG("Cache " << path << " has an invalid row size " << header.rowSize);
+        return false;
+    }
+    const uint64_t rowsBytes = static_cast<uint64_t>(header.rowCount) * header.rowSize;
+    if (header.rowsOffset > file.size || rowsBytes > file.size - header.rowsOffset ||
+        header.stringsOffset > file.size || header.stringsSize > file.size - header.stringsOffset) {
+        LOG_DEBUG("Cache " << path << " is truncated");
+        return false;
+    }
+
+    const char* strings = reinterpret_cast<const char*>(file.data + header.stringsOffset);
+    tables.clear();
+    tables.resize(header.rowCount);
+    for (uint32_t i = 0; i < header.rowCount; ++i) {
+        CacheRow row;
+        std::memcpy(&row, file.data + header.rowsOffset + static_cast<uint64_t>(i) * sizeof(CacheRow), sizeof(CacheRow));
+        for (size_t f = 0; f < STRING_FIELD_COUNT; ++f) {
+            if (static_cast<uint64_t>(row.strings[f].offset) + row.strings[f].length > header.stringsSize) {
+                LOG_DEBUG("Cache " << path << " has a string out of bounds at row " << i);
+                tables.clear();
+                return false;
+            }
+        }
+        TableEntry& entry = tables[i];
+        for (size_t f = 0; f < STRING_FIELD_COUNT; ++f) {
+            const StringRef& ref = row.strings[f];
+            (entry.*STRING_FIELDS[f]).assign(strings + ref.offset, ref.length);
+        }
+        entry.status = row.status;
+        entry.stamp.size = row.size;
+        entry.stamp.mtime = row.mtime;
+        entry.stamp.inode = row.inode;
+        entry.playCount = row.playCount;
+        entry.vbsModified = (row.flags & ROW_VBS_MODIFIED) != 0;
+        entry.iniModified = (row.flags & ROW_INI_MODIFIED) != 0;
+        entry.requiresPinmame = (row.flags & ROW_REQUIRES_PINMAME) != 0;
+        entry.scriptStamp = {row.scriptSize, row.scriptMtime, row.scriptInode};
+        entry.scriptHash = row.scriptHash;
+        entry.vbsStamp = {row.vbsSize, row.vbsMtime, row.vbsInode};
+        entry.vbsHash = row.vbsHash;
+        entry.iniStamp = {row.iniSize, row.iniMtime, row.iniInode};
+        entry.iniBaseStamp = {row.iniBaseSize, row.iniBaseMtime, row.iniBaseInode};
+        entry.iniOverrides.clear();
+        if (row.iniOverrides.length > 0) {
+            if (static_cast<uint64_t>(row.iniOverrides.offset) + row.iniOverrides.length > header.stringsSize) {
+                LOG_DEBUG("Cache " << path << " has a string out of bounds at row " << i);
+                tables.clear();
+                return false;
+            }
+            std::string joined(strings + row.iniOverrides.offset, row.iniOverrides.length);
+            for (size_t pos = 0; pos <= joined.size();) {
+                size_t next = joined.find('\n', pos);
+                if (next == std::string::npos) next = joined.size();
+                entry.iniOverrides.push_back(joined.substr(pos, next - pos));
+                pos = next + 1;
+            }
+        }
+    }
+    lastUpdated = header.lastUpdated;
+    if (header.probeSettings != probeSettingsHash(config)) {
+        // Media or ROM paths changed since the rows were probed: report the cache as older
+        // than every table folder so the loader re-probes all rows
+        LOG_DEBUG("Probe settings changed since the cache was written, marking all rows stale");
+        lastUpdated = 0;
+    }
+    LOG_DEBUG("Loaded " << tables.size() << " tables from binary cache: " << path);
+    return true;
+}
+
+bool TableCache::save(const std::vector<TableEntry>& tables) const {
+    std::string strings;
+    std::unordered_map<std::string, StringRef> interned; // Authors, years and ROM names repeat a lot
+    auto intern = [&](const std::string& value) {
+        auto it = interned.find(value);
+        if (it == interned.end()) {
+            StringRef ref{static_cast<uint32_t>(strings.size()), static_cast<uint32_t>(value.size())};
+            strings += value;
+            it = interned.emplace(value, ref).first;
+        }
+        return it->second;
+    };
+    std::vector<CacheRow> rows(tables.size());
+    for (size_t i = 0; i < tables.size(); ++i) {
+        const TableEntry& entry = tables[i];
+        CacheRow& row = rows[i];
+        std::memset(&row, 0, sizeof(row));
+        for (size_t f = 0; f < STRING_FIELD_COUNT; ++f) {
+            row.strings[f] = intern(entry.*STRING_FIELDS[f]);
+        }
+        row.size = entry.stamp.size;
+        row.mtime = entry.stamp.mtime;
+        row.inode = entry.stamp.inode;
+        row.playCount = entry.playCount;
+        row.flags = (entry.vbsModified ? ROW_VBS_MODIFIED : 0u) |
+                    (entry.iniModified ? ROW_INI_MODIFIED : 0u) |
+                    (entry.requiresPinmame ? ROW_REQUIRES_PINMAME : 0u);
+        row.scriptSize = entry.scriptStamp.size;
+        row.scriptMtime = entry.scriptStamp.mtime;
+        row.scriptInode = entry.scriptStamp.inode;
+        row.scriptHash = entry.scriptHash;
+        row.vbsSize = entry.vbsStamp.size;
+        row.vbsMtime = entry.vbsStamp.mtime;
+        row.vbsInode = entry.vbsStamp.inode;
+        row.vbsHash = entry.vbsHash;
+        row.iniSize = entry.iniStamp.size;
+        row.iniMtime = entry.iniStamp.mtime;
+        row.iniInode = entry.iniStamp.inode;
+        row.iniBaseSize = entry.iniBaseStamp.size;
+        row.iniBaseMtime = entry.iniBaseStamp.mtime;
+        row.iniBaseInode = entry.iniBaseStamp.inode;
+        std::string overrides;
+        for (const auto& key : entry.iniOverrides) {
+            if (!overrides.empty()) overrides += '\n';
+            overrides += key;
+        }
+        row.iniOverrides = intern(overrides);
+        row.status = entry.status;
+    }
+
+    CacheHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, CACHE_MAGIC, sizeof(CACHE_MAGIC));
+    header.version = FORMAT_VERSION;
+    header.rowCount = static_cast<uint32_t>(rows.size());
+    header.lastUpdated = std::chrono::system_clock::now().time_since_epoch().count();
+    header.rowsOffset = sizeof(CacheHeader);
+    header.stringsOffset = header.rowsOffset + rows.size() * sizeof(CacheRow);
+    header.stringsSize = strings.size();
+    header.rowSize = sizeof(CacheRow);
+    header.probeSettings = probeSettingsHash(config);
+
+    std::lock_guard<std::mutex> lock(saveMutex);
+    const std::string path = getCachePath();
+    const std::string tmpPath = path + ".tmp";
+    {
+        std::ofstream file(tmpPath, std::ios::binary | std::ios::trunc);
+        if (!file.is_open()) {
+            std::cerr << "Failed to open " << tmpPath << " for writing" << std::endl;
+            return false;
+        }
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        file.write(reinterpret_cast<const char*>(rows.data()), static_cast<std::streamsize>(rows.size() * sizeof(CacheRow)));
+        file.write(strings.data(), static_cast<std::streamsize>(strings.size()));
+        if (!file.good()) {
+            std::cerr << "Failed to write " << tmpPath << std::endl;
+            return false;
+        }
+    }
+    std::error_code ec;
+    std::filesystem::rename(tmpPath, path, ec);
+    if (ec) {
+        std::cerr << "Failed to replace " << path << ": " << ec.message() << std::endl;
+        return false;
+    }
+    LOG_DEBUG("Saved " << tables.size() << " tables to binary cache: " << path << " (" << strings.size() << " string bytes)");
+
+    if (config.getExportJsonIndex()) {
+        exportJson(tables);
+    }
+    return true;
+}
+
+void TableCache::exportJson(const std::vector<TableEntry>& tables) const {
+    json j;
+    j["last_updated"] = std::chrono::system_clock::now().time_since_epoch().count();
+    j["tables"] = json::array();
+    for (const auto& t : tables) {
+        json tj;
+        tj["filepath"] = t.filepath;
+        tj["filename"] = t.filename;
+        tj["year"] = t.year;
+        tj["author"] = t.author;
+        tj["name"] = t.name;
+        tj["version"] = t.version;
+        json status = json::array();
+        for (size_t bit = 0; bit < TABLE_STATUS_COUNT; ++bit) {
+            if (t.status & (1u << bit)) status.push_back(TABLE_STATUS_NAMES[bit]);
+        }
+        tj["status"] = status;
+        tj["vbsModified"] = t.vbsModified;
+        tj["iniModified"] = t.iniModified;
+        tj["iniOverrides"] = t.iniOverrides;
+        tj["requiresPinmame"] = t.requiresPinmame;
+        tj["gameName"] = t.gameName;
+        tj["lastRun"] = t.lastRun;
+        tj["playCount"] = t.playCount;
+        tj["size"] = t.stamp.size;
+        tj["mtime"] = t.stamp.mtime;
+        tj["inode"] = t.stamp.inode;
+        j["tables"].push_back(tj);
+    }
+    std::ofstream file(getJsonPath());
+    file << j.dump(2);
+    LOG_DEBUG("Exported " << tables.size() << " tables to " << getJsonPath());
+}
+
+bool TableCache::loadLegacyJson(std::vector<TableEntry>& tables, long long& lastUpdated) const {
+    std::ifstream file(getJsonPath());
+    if (!file.is_open()) {
+        return false;
+    }
+    json j;
+    try {
+        file >> j;
+    } catch (const json::parse_error& e) {
+        LOG_DEBUG("Failed to parse legacy cache " << getJsonPath() << ": " << e.what());
+        return false;
+    }
+    if (!j.contains("tables") || !j["tables"].is_array()) {
+        return false;
+    }
+    tables.clear();
+    for (const auto& t : j["tables"]) {
+        TableEntry entry;
+        entry.filepath = t.value("filepath", "");
+        entry.filename = t.value("filename", "");
+        entry.year = t.value("year", "");
+        entry.author = t.value("author", "");
+        entry.name = t.value("name", "");
+        entry.version = t.value("version", "");
+        if (t.contains("status") && t["status"].is_array()) {
+            for (const auto& name : t["status"]) {
+                if (!name.is_string()) continue;
+                for (size_t bit = 0; bit < TABLE_STATUS_COUNT; ++bit) {
+                    if (name.get<std::string>() == TABLE_STATUS_NAMES[bit]) entry.status |= 1u << bit;
+                }
+            }
+        } else {
+            // Exports from before the status bits hold the display strings
+            const std::string legacy[] = {
+                t.value("extraFiles", ""), t.value("rom", ""), t.value("udmd", ""), t.value("alts", ""),
+                t.value("altc", ""), t.value("pup", ""), t.value("music", ""), t.value("images", ""),
+                t.value("videos", ""),
+            };
+            entry.status = legacyStatus(legacy);
+        }
+        entry.vbsModified = t.value("vbsModified", false);
+        entry.iniModified = t.value("iniModified", false);
+        entry.requiresPinmame = t.value("requiresPinmame", false);
+        entry.gameName = t.value("gameName", "");
+        entry.lastRun = t.value("lastRun", "clear");
+        entry.playCount = t.value("playCount", 0);
+        entry.stamp.size = t.value("size", static_cast<uint64_t>(0));
+        entry.stamp.mtime = t.value("mtime", static_cast<int64_t>(0));
+        entry.stamp.inode = t.value("inode", static_cast<uint64_t>(0));
+        tables.push_back(entry);
+    }
+    lastUpdated = j.value("last_updated", 0LL);
+    LOG_DEBUG("Imported " << tables.size() << " tables from legacy cache: " << getJsonPath());
+    return true;
+}
\ No newline at end of file
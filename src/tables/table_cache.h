@@ -0,0 +1,51 @@
+#ifndef TABLE_CACHE_H
+#define TABLE_CACHE_H
+
+#include "utils/logging.h"
+#include "utils/structures.h"
+#include "config/iconfig_provider.h"
+#include <vector>
+#include <string>
+#include <cstdint>
+
+// Versioned binary table cache (resources/tables_index.bin).
+// Layout: fixed header, fixed-size rows holding offset/length pairs, then a deduplicated
+// string table. The file is mmap()-ed on load and rows are built without any DOM.
+class TableCache {
+public:
+    // Constructor: Initializes with a config provider reference
+    TableCache(IConfigProvider& config);
+
+    // Loads all cached rows
+    // tables: Vector to populate with cached table entries
+    // lastUpdated: Receives the cache write time (ns since epoch)
+    // Returns: false if the cache is missing, corrupt or from another format version
+    bool load(std::vector<TableEntry>& tables, long long& lastUpdated) const;
+
+    // Writes all rows atomically (temp file + rename), plus the JSON export if enabled
+    // tables: Vector of table entries to save
+    // Returns: false if the cache could not be written
+    bool save(const std::vector<TableEntry>& tables) const;
+
+    // Path of the binary cache file
+    std::string getCachePath() const;
+
+    // Path of the trigram search index kept next to the cache (see SearchIndex)
+    std::string getSearchIndexPath() const;
+
+    // Path of the optional JSON export (also read once to migrate older installs)
+    std::string getJsonPath() const;
+
+    static const uint32_t FORMAT_VERSION = 4;
+
+private:
+    // Writes a pretty-printed JSON copy of the rows for external tools
+    void exportJson(const std::vector<TableEntry>& tables) const;
+
+    // Imports the pre-binary tables_index.json so play history survives the upgrade
+    bool loadLegacyJson(std::vector<TableEntry>& tables, long long& lastUpdated) const;
+
+    IConfigProvider& config; // Reference to configuration provider
+};
+
+#endif // TABLE_CACHE_H
\ No newline at end of file
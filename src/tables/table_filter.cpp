@@ -1,58 +1,161 @@
 #include "tables/table_filter.h"
-#include <cctype>
-#include <algorithm> // For std::transform
-
-void TableFilter::filterTables(const std::vector<TableEntry>& tables, std::vector<TableEntry>& filteredTables, const std::string& query) {
-    filteredTables.clear();
-    
-    // If the query is empty, show all tables
-    if (query.empty()) {
-        filteredTables = tables;
+#include <algorithm>
+
+void TableFilter::filterTables(const TableStore& tables, const SearchIndex& index, uint64_t dataVersion,
+                               std::vector<size_t>& order, const std::string& query) {
+    // Fold the query the same way the search keys were folded
+    std::string foldedQuery = SearchIndex::fold(query);
+
+    const bool sameData = hasResult && dataVersion == lastDataVersion;
+    const bool sameSort = sortSpecs == lastSortSpecs;
+    const bool sameMode = fuzzy == lastFuzzy;
+    if (sameData && sameSort && sameMode && foldedQuery == lastQuery) {
+        return; // Nothing changed since the last frame
+    }
+
+    // Compiled once per query; the predicate order is tuned to the rows it runs on
+    TableQuery compiled(foldedQuery);
+    compiled.orderBySelectivity(tables);
+    const std::string& text = compiled.getText();
+
+    if (fuzzy && !text.empty()) {
+        // Scores depend on the whole query, so ranked results are always recomputed
+        fuzzyFilter(tables, index, dataVersion, compiled, order);
+    } else if (sameData && sameMode && foldedQuery == lastQuery) {
+        // Only the sort spec changed
+        resortTables(tables, dataVersion, order);
+    } else if (sameData && sameSort && sameMode && !compiled.hasPredicates() && !lastHadPredicates &&
+               foldedQuery.find(lastQuery) != std::string::npos) {
+        // Every row matching the longer query also matched the previous one, and the
+        // previous result is already sorted, so dropping non-matches is enough. Queries with
+        // predicates don't narrow: typing "has:whee" into "has:wheel" turns text into a predicate.
+        order.erase(std::remove_if(order.begin(), order.end(), [&](size_t row) {
+            return !matches(tables, row, foldedQuery);
+        }), order.end());
     } else {
-        // Convert the search query to lowercase for case-insensitive matching
-        std::string lowerQuery = query;
-        std::transform(lowerQuery.begin(), lowerQuery.end(), lowerQuery.begin(), ::tolower);
-
-        // Iterate through all tables and check if either the name or filename matches the query
-        for (const auto& table : tables) {
-            // Convert table name to lowercase for comparison
-            std::string lowerName = table.name;
-            std::transform(lowerName.begin(), lowerName.end(), lowerName.begin(), ::tolower);
-
-            // Convert filename to lowercase for comparison
-            std::string lowerFilename = table.filename;
-            std::transform(lowerFilename.begin(), lowerFilename.end(), lowerFilename.begin(), ::tolower);
-
-            // Check if either the name or filename contains the query
-            if (lowerName.find(lowerQuery) != std::string::npos || 
-                lowerFilename.find(lowerQuery) != std::string::npos) {
-                filteredTables.push_back(table);
-            }
+        index.find(tables, text, order);
+        if (compiled.hasPredicates()) {
+            order.erase(std::remove_if(order.begin(), order.end(), [&](size_t row) {
+                return !compiled.matches(tables, row);
+            }), order.end());
         }
+        sortTables(tables, dataVersion, order);
     }
 
-    // Sort the filtered tables based on the current sort specifications
-    std::sort(filteredTables.begin(), filteredTables.end(), [this](const TableEntry& a, const TableEntry& b) {
-        switch (sortColumn) {
-            case 0: return sortAscending ? a.year < b.year : a.year > b.year;
-            case 1: return sortAscending ? a.author < b.author : a.author > b.author;
-            case 2: return sortAscending ? a.name < b.name : a.name > b.name;
-            case 3: return sortAscending ? a.version < b.version : a.version > b.version;
-            case 4: return sortAscending ? a.extraFiles < b.extraFiles : a.extraFiles > b.extraFiles;
-            case 5: return sortAscending ? a.rom < b.rom : a.rom > b.rom;
-            case 6: return sortAscending ? a.udmd < b.udmd : a.udmd > b.udmd;
-            case 7: return sortAscending ? a.alts < b.alts : a.alts > b.alts;
-            case 8: return sortAscending ? a.altc < b.altc : a.altc > b.altc;
-            case 9: return sortAscending ? a.pup < b.pup : a.pup > b.pup;
-            case 10: return sortAscending ? a.music < b.music : a.music > b.music;
-            case 11: return sortAscending ? a.images < b.images : a.images > b.images;
-            case 12: return sortAscending ? a.videos < b.videos : a.videos > b.videos;
-            default: return false;
+    hasResult = true;
+    lastQuery = foldedQuery;
+    lastHadPredicates = compiled.hasPredicates();
+    lastSortSpecs = sortSpecs;
+    lastFuzzy = fuzzy;
+    lastDataVersion = dataVersion;
+    ++generation;
+}
+
+bool TableFilter::matches(const TableStore& tables, size_t row, const std::string& foldedQuery) {
+    // Search keys are folded once when the row is loaded, so matching allocates nothing
+    return tables.searchKey(row).find(foldedQuery) != std::string_view::npos;
+}
+
+void TableFilter::fuzzyFilter(const TableStore& tables, const SearchIndex& index, uint64_t dataVersion,
+                              const TableQuery& query, std::vector<size_t>& order) {
+    FuzzyMatcher matcher(query.getText());
+    order.clear();
+
+    const std::vector<uint64_t>& masks = index.getCharMasks();
+    if (masks.size() == tables.size()) {
+        // Branch-free pass over the contiguous mask column, which the compiler vectorizes;
+        // only rows holding every character of the query go on to be scored
+        const uint64_t need = matcher.getQueryMask();
+        const uint64_t* mask = masks.data();
+        const size_t count = masks.size();
+        maskPass.resize(count);
+        uint8_t* pass = maskPass.data();
+        for (size_t i = 0; i < count; ++i) {
+            pass[i] = static_cast<uint8_t>((mask[i] & need) == need);
+        }
+        for (size_t i = 0; i < count; ++i) {
+            if (pass[i]) order.push_back(i);
+        }
+    } else {
+        for (size_t i = 0; i < tables.size(); ++i) order.push_back(i);
+    }
+
+    rowScores.resize(tables.size());
+    size_t kept = 0;
+    for (size_t row : order) {
+        // Predicates are far cheaper than scoring, so they reject rows first
+        if (!query.matches(tables, row)) continue;
+        int score = matcher.score(tables.searchKey(row), tables.fuzzyKey(row));
+        if (score > 0) {
+            rowScores[row] = score;
+            order[kept++] = row;
         }
+    }
+    order.resize(kept);
+
+    // Column order first, so the stable sort by score keeps it among equal scores
+    sortTables(tables, dataVersion, order);
+    std::stable_sort(order.begin(), order.end(), [this](size_t a, size_t b) {
+        return rowScores[a] > rowScores[b];
     });
 }
 
-void TableFilter::setSortSpecs(int columnIdx, bool ascending) {
-    sortColumn = columnIdx;
-    sortAscending = ascending;
+void TableFilter::sortTables(const TableStore& tables, uint64_t dataVersion, std::vector<size_t>& order) {
+    gatherKeys(tables, dataVersion);
+    std::stable_sort(order.begin(), order.end(), [this](size_t a, size_t b) {
+        return rowLess(a, b, 0);
+    });
+}
+
+void TableFilter::resortTables(const TableStore& tables, uint64_t dataVersion, std::vector<size_t>& order) {
+    size_t shared = 0;
+    while (shared < sortSpecs.size() && shared < lastSortSpecs.size() && sortSpecs[shared] == lastSortSpecs[shared]) {
+        ++shared;
+    }
+    if (shared == sortSpecs.size()) return; // Trailing levels were dropped; order already satisfies the rest
+    if (shared == 0) {
+        // New primary key: start from the previous permutation so ties keep their order
+        sortTables(tables, dataVersion, order);
+        return;
+    }
+
+    gatherKeys(tables, dataVersion);
+    auto sameRun = [this, shared](size_t a, size_t b) {
+        for (size_t s = 0; s < shared; ++s) {
+            if (specKeys[s][a] != specKeys[s][b]) return false;
+        }
+        return true;
+    };
+    for (size_t begin = 0; begin < order.size();) {
+        size_t end = begin + 1;
+        while (end < order.size() && sameRun(order[begin], order[end])) ++end;
+        if (end - begin > 1) {
+            std::stable_sort(order.begin() + begin, order.begin() + end, [this, shared](size_t a, size_t b) {
+                return rowLess(a, b, shared);
+            });
+        }
+        begin = end;
+    }
+}
+
+void TableFilter::gatherKeys(const TableStore& tables, uint64_t dataVersion) {
+    specKeys.clear();
+    for (const auto& spec : sortSpecs) {
+        specKeys.push_back(sortKeys.get(tables, spec.column, dataVersion).data());
+    }
+}
+
+bool TableFilter::rowLess(size_t a, size_t b, size_t firstSpec) const {
+    for (size_t s = firstSpec; s < sortSpecs.size(); ++s) {
+        uint64_t keyA = specKeys[s][a];
+        uint64_t keyB = specKeys[s][b];
+        if (keyA == keyB) continue;
+        if (keyA == SortKeys::MISSING || keyB == SortKeys::MISSING) return keyB == SortKeys::MISSING;
+        return sortSpecs[s].ascending ? keyA < keyB : keyA > keyB;
+    }
+    return false;
+}
+
+void TableFilter::setSortSpecs(const std::vector<SortSpec>& specs) {
+    sortSpecs = specs;
 }
\ No newline at end of file
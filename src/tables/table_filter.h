@@ -1,18 +1,88 @@
 #ifndef TABLE_FILTER_H
 #define TABLE_FILTER_H
 
-#include "utils/structures.h"
+#include "tables/search_index.h"
+#include "tables/fuzzy_matcher.h"
+#include "tables/table_query.h"
+#include "tables/sort_keys.h"
 #include <vector>
+#include <string>
+#include <cstdint>
 #include <algorithm>
 
+// One level of a sort: rows are ordered by the first spec, ties by the next one and so on
+struct SortSpec {
+    int column;     // SortKeys::Column
+    bool ascending;
+    bool operator==(const SortSpec& other) const { return column == other.column && ascending == other.ascending; }
+    bool operator!=(const SortSpec& other) const { return !(*this == other); }
+};
+
 class TableFilter {
 public:
-    TableFilter() : sortColumn(0), sortAscending(true) {}
-    void filterTables(const std::vector<TableEntry>& tables, std::vector<TableEntry>& filteredTables, const std::string& query);
-    void setSortSpecs(int columnIdx, bool ascending);
+    TableFilter() : sortSpecs{{SortKeys::Year, true}} {}
+
+    // Filters and sorts tables into order, skipping all work when the query, the sort spec and
+    // dataVersion are unchanged since the last call. A query that contains the previous one
+    // narrows the previous result instead of rescanning, and a sort change alone only re-sorts.
+    // Sorting is stable, so rows with equal keys keep their previous relative order.
+    // tables: Authoritative table list
+    // index: Search index built for tables, used when the query has to be matched from scratch
+    // dataVersion: Changes whenever tables (or any row in it) changes
+    // order: Indices into tables from the previous call, updated in place
+    // query: Search text matched against name and filename, ignoring case and accents, plus
+    //        field predicates such as "has:wheel" or "year:1980..1989" (see TableQuery)
+    void filterTables(const TableStore& tables, const SearchIndex& index, uint64_t dataVersion,
+                      std::vector<size_t>& order, const std::string& query);
+
+    // specs: Sort levels, most significant first; empty keeps rows in filepath order
+    void setSortSpecs(const std::vector<SortSpec>& specs);
+
+    // Switches between substring search and ranked fuzzy search (see FuzzyMatcher); fuzzy
+    // results are ordered by score, with the column sort only breaking ties
+    void setFuzzy(bool enabled) { fuzzy = enabled; }
+
+    // Increases every time order is rebuilt, narrowed or re-sorted
+    uint64_t getGeneration() const { return generation; }
+
 private:
-    int sortColumn;
-    bool sortAscending;
+    static bool matches(const TableStore& tables, size_t row, const std::string& foldedQuery);
+
+    // Scores every row that can match the free text and passes the predicates, then orders
+    // the matches by score
+    void fuzzyFilter(const TableStore& tables, const SearchIndex& index, uint64_t dataVersion,
+                     const TableQuery& query, std::vector<size_t>& order);
+
+    // Stable sort of order by every sort spec
+    void sortTables(const TableStore& tables, uint64_t dataVersion, std::vector<size_t>& order);
+
+    // Re-sorts order, which is sorted by lastSortSpecs, for the current specs. The levels both
+    // share already hold, so only runs of rows that tie on them are sorted by the rest.
+    void resortTables(const TableStore& tables, uint64_t dataVersion, std::vector<size_t>& order);
+
+    // Points specKeys at the sort keys of each spec's column
+    void gatherKeys(const TableStore& tables, uint64_t dataVersion);
+
+    // Compares two rows by the sort specs from firstSpec on; rows without a value go last
+    bool rowLess(size_t a, size_t b, size_t firstSpec) const;
+
+    std::vector<SortSpec> sortSpecs;
+    SortKeys sortKeys;
+    std::vector<const uint64_t*> specKeys; // Per sort spec: key of every row
+    bool fuzzy = false;
+
+    // Inputs of the last computed result
+    bool hasResult = false;
+    std::string lastQuery; // Folded
+    bool lastHadPredicates = false;
+    std::vector<SortSpec> lastSortSpecs;
+    bool lastFuzzy = false;
+    uint64_t lastDataVersion = 0;
+    uint64_t generation = 0;
+
+    // Fuzzy search scratch space, reused across queries
+    std::vector<uint8_t> maskPass; // Per row: the row has every character of the query
+    std::vector<int> rowScores;    // Per row: score of the last fuzzy query, valid for rows in order
 };
 
 #endif // TABLE_FILTER_H
\ No newline at end of file
@@ -0,0 +1,89 @@
+#ifndef TABLE_LIST_H
+#define TABLE_LIST_H
+
+#include "tables/table_store.h"
+#include <vector>
+#include <string>
+#include <string_view>
+#include <mutex>
+#include <cstddef>
+
+// One row of a TableStore, read column by column. Text is returned as views into the store,
+// which are not NUL-terminated; print them with "%.*s" or TextUnformatted(begin, end).
+class TableRow {
+public:
+    TableRow(const TableStore& store, size_t row) : store(&store), row(row) {}
+
+    TableId id() const { return store->id(row); }
+    std::string filepath() const { return store->filepath(row); }
+    std::string folder() const { return store->folder(row); }
+    std::string_view filename() const { return store->filename(row); }
+    std::string_view name() const { return store->name(row); }
+    std::string_view year() const { return store->year(row); }
+    std::string_view author() const { return store->author(row); }
+    std::string_view version() const { return store->version(row); }
+    std::string_view gameName() const { return store->gameName(row); }
+    std::string_view iniOverrides() const { return store->iniOverrides(row); } // '\n'-separated
+    uint32_t status() const { return store->status(row); }
+    bool vbsModified() const { return store->vbsModified(row); }
+    bool iniModified() const { return store->iniModified(row); }
+    bool failed() const { return store->failed(row); }
+    int playCount() const { return store->playCount(row); }
+
+private:
+    const TableStore* store;
+    size_t row;
+};
+
+// Filtered and sorted view over the rows owned by TableManager: position i maps to
+// row order[i] of the store, so no row is ever copied to build it. The view keeps the table
+// lock held for its lifetime, so it is meant to live for one frame on the UI thread.
+// Positions change with every re-sort or refresh; hold on to a table across frames by its id().
+class TableList {
+public:
+    static constexpr size_t npos = static_cast<size_t>(-1);
+
+    // positions: Inverse of order, position of each store row or npos if it is filtered out
+    // dataVersion: TableManager's version of the rows, see getDataVersion()
+    // rowSetVersion: TableManager's version of the set of rows, see getRowSetVersion()
+    TableList(std::unique_lock<std::recursive_mutex> lock, const TableStore& rows, const std::vector<size_t>& order,
+              const std::vector<size_t>& positions, uint64_t dataVersion, uint64_t rowSetVersion)
+        : lock(std::move(lock)), rows(&rows), order(&order), positions(&positions), dataVersion(dataVersion),
+          rowSetVersion(rowSetVersion) {}
+
+    size_t size() const { return order->size(); }
+
+    // Changes when rows were added, removed or updated, but not when only the query or sort did
+    uint64_t getDataVersion() const { return dataVersion; }
+    // Changes only when the store was replaced, i.e. rows may have been added or removed;
+    // probe results and launches leave it alone
+    uint64_t getRowSetVersion() const { return rowSetVersion; }
+    bool empty() const { return order->empty(); }
+
+    // Row at position i of the filtered view
+    TableRow operator[](size_t i) const { return TableRow(*rows, (*order)[i]); }
+
+    // Position of a table in the filtered view
+    // Returns: npos if the table is filtered out or no longer exists
+    size_t find(TableId id) const {
+        size_t row = rows->find(id);
+        return row != TableStore::npos ? (*positions)[row] : npos;
+    }
+
+    // Path of a table whether or not the filter shows it
+    // Returns: Empty if the table no longer exists
+    std::string filepathOf(TableId id) const {
+        size_t row = rows->find(id);
+        return row != TableStore::npos ? rows->filepath(row) : std::string();
+    }
+
+private:
+    std::unique_lock<std::recursive_mutex> lock;
+    const TableStore* rows;
+    const std::vector<size_t>* order;
+    const std::vector<size_t>* positions;
+    uint64_t dataVersion;
+    uint64_t rowSetVersion;
+};
+
+#endif // TABLE_LIST_H
\ No newline at end of file
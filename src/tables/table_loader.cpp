@@ -1,143 +1,150 @@
 #include "tables/table_loader.h"
+#include "tables/name_normalizer.h"
+#include "tables/table_updater.h"
 #include <fstream>
 #include <iostream>
-#include <functional> // For std::hash
-#include <thread>     // For parallel parsing
 #include <algorithm>
+#include <iterator>
+#include <memory_resource>
 #include <cctype>
-#include <sstream>
 #include <vector>
 #include <string>
-#include <regex>
+#include <set>
+#include <thread>
+#include <unordered_map>
+#include <sys/stat.h>
 
-TableLoader::TableLoader(IConfigProvider& config) : config(config) {}
+namespace {
 
-void TableLoader::load(std::vector<TableEntry>& tables, std::vector<TableEntry>& filteredTables, bool forceVpxToolIndex) {
-    std::string cachePath = config.getBasePath() + "resources/tables_index.json";
-    std::string indexPath = config.getTablesDir() + "/" + config.getVpxtoolIndexFile();
-    LOG_DEBUG("Checking cache at " << cachePath << " and index at " << indexPath);
+// Rows of the vpxtool index parsed per thread pool task
+const size_t PARSE_CHUNK_ROWS = 32;
 
-    bool useCache = false;
-    if (!forceVpxToolIndex && std::filesystem::exists(cachePath) && std::filesystem::exists(indexPath)) {
-        std::ifstream file(cachePath);
-        if (!file.is_open()) {
-            LOG_DEBUG("Failed to open cache file: " << cachePath);
-        } else {
-            json j;
-            file >> j;
-            bool hasRequiredFields = !j["tables"].empty() && 
-                                     j["tables"][0].contains("requiresPinmame") && 
-                                     j["tables"][0].contains("gameName") && 
-                                     j["tables"][0].contains("lastRun");
-            file.close();
-            if (hasRequiredFields) {
-                auto tablesDirLastWrite = std::filesystem::last_write_time(config.getTablesDir()).time_since_epoch().count();
-                auto lastUpdated = j["last_updated"].get<long long>();
-                std::string cachedHash = j.contains("tables_hash") ? j["tables_hash"].get<std::string>() : "";
-                std::string currentHash = computeTablesHash(config.getTablesDir());
-                if (lastUpdated >= tablesDirLastWrite && cachedHash == currentHash) {
-                    LOG_DEBUG("Cache is valid (hash match: " << cachedHash << "), loading from cache: " << cachePath);
-                    useCache = true;
-                } else {
-                    LOG_DEBUG("Cache outdated (time: " << lastUpdated << " < " << tablesDirLastWrite 
-                              << ", hash: " << cachedHash << " != " << currentHash << "), regenerating...");
-                }
-            } else {
-                LOG_DEBUG("Cache lacks required fields, regenerating index...");
-                std::filesystem::remove(cachePath);
-            }
+// True when lexically_normal() would return path unchanged, so most index paths skip the conversion
+bool isLexicallyNormal(std::string_view path) {
+    for (size_t start = 0; start <= path.size();) {
+        size_t end = std::min(path.find('/', start), path.size());
+        std::string_view part = path.substr(start, end - start);
+        bool edge = start == 0 || end == path.size();
+        if ((part.empty() && !edge) || part == "." || part == "..") return false;
+        start = end + 1;
+    }
+    return true;
+}
+
+} // namespace
+
+TableLoader::TableLoader(IConfigProvider& config) : config(config), cache(config) {}
+
+void TableLoader::load(std::vector<TableEntry>& tables, std::vector<size_t>& staleIndices, bool forceVpxToolIndex, TaskPriority priority) {
+    LOG_DEBUG("Checking cache at " << cache.getCachePath());
+
+    std::vector<TableEntry> cached;
+    long long lastUpdated = 0;
+    if (!forceVpxToolIndex) {
+        if (!cache.load(cached, lastUpdated)) {
+            LOG_DEBUG("Cache missing or unusable, indexing all tables...");
+            cached.clear();
         }
     } else {
-        LOG_DEBUG("Cache or index missing (cache: " << std::filesystem::exists(cachePath) 
-                  << ", index: " << std::filesystem::exists(indexPath) << "), generating index...");
+        LOG_DEBUG("Re-index forced, ignoring cache");
     }
 
-    if (useCache) {
-        loadFromCache(cachePath, tables);
-    } else {
-        generateIndex();
-        loadTables(tables);
-        saveToCache(cachePath, tables);
+    std::unordered_map<std::string, const TableEntry*> cachedByPath;
+    for (const auto& entry : cached) {
+        cachedByPath[entry.filepath] = &entry;
+    }
+
+    // Reuse every cached row whose .vpx stamp is unchanged; only added or modified files get parsed
+    std::vector<std::string> vpxFiles = findVpxFiles(config.getTablesDir());
+    const std::vector<std::string> probeDirs = FolderSnapshot::subdirectories(TableUpdater::getProbePaths(config));
+    std::vector<std::string> toParse;
+    std::vector<FileStamp> toParseStamps;
+    std::set<std::string> stalePaths;
+    tables.clear();
+    for (const auto& path : vpxFiles) {
+        FileStamp stamp = statFile(path);
+        auto it = cachedByPath.find(path);
+        if (it != cachedByPath.end() && it->second->stamp == stamp) {
+            tables.push_back(*it->second);
+            // Media and sidecar files live next to the .vpx or in its media/ROM subfolders; a newer
+            // directory means they need a re-probe
+            if (folderModifiedSince(path, probeDirs, lastUpdated)) {
+                stalePaths.insert(path);
+            }
+        } else {
+            toParse.push_back(path);
+            toParseStamps.push_back(stamp);
+        }
+    }
+    LOG_DEBUG("Manifest: " << tables.size() << " unchanged, " << toParse.size() << " new or modified, "
+              << cached.size() << " previously cached");
+
+    if (!toParse.empty()) {
+        std::vector<TableEntry> parsed;
+        loadTables(toParse, parsed, cachedByPath, priority);
+        std::unordered_map<std::string, FileStamp> stampByPath;
+        for (size_t i = 0; i < toParse.size(); ++i) {
+            stampByPath[toParse[i]] = toParseStamps[i];
+        }
+        for (auto& entry : parsed) {
+            auto stamp = stampByPath.find(entry.filepath);
+            if (stamp != stampByPath.end()) entry.stamp = stamp->second;
+            stalePaths.insert(entry.filepath);
+            tables.push_back(std::move(entry));
+        }
+        std::sort(tables.begin(), tables.end(), [](const TableEntry& a, const TableEntry& b) {
+            return a.filepath < b.filepath;
+        });
+    }
+
+    staleIndices.clear();
+    for (size_t i = 0; i < tables.size(); ++i) {
+        if (stalePaths.count(tables[i].filepath)) staleIndices.push_back(i);
     }
-    filteredTables = tables;
+
     std::cerr << "Loaded " << tables.size() << " tables." << std::endl;
 }
 
-void TableLoader::loadFromCache(const std::string& jsonPath, std::vector<TableEntry>& tables) {
-    std::ifstream file(jsonPath);
-    if (!file.is_open()) {
-        LOG_DEBUG("Could not open cache: " << jsonPath);
-        loadTables(tables); // Fallback to full load
-        return;
+void TableLoader::reindex(const std::vector<std::string>& vpxFiles, std::vector<TableEntry>& tables, const std::vector<TableEntry>& current, TaskPriority priority) {
+    std::unordered_map<std::string, const TableEntry*> previous;
+    for (const auto& entry : current) {
+        previous[entry.filepath] = &entry;
+    }
+    std::vector<std::string> existing;
+    for (const auto& path : vpxFiles) {
+        if (std::filesystem::exists(path)) existing.push_back(path);
     }
-    json j;
-    file >> j;
     tables.clear();
-    for (const auto& t : j["tables"]) {
-        TableEntry entry;
-        entry.filepath = t["filepath"];
-        entry.filename = t["filename"];
-        entry.year = t["year"];
-        entry.author = t["author"];
-        entry.name = t["name"];
-        entry.version = t["version"];
-        entry.extraFiles = t["extraFiles"];
-        entry.rom = t["rom"];
-        entry.udmd = t["udmd"];
-        entry.alts = t["alts"];
-        entry.altc = t["altc"];
-        entry.pup = t["pup"];
-        entry.music = t["music"];
-        entry.images = t["images"];
-        entry.videos = t["videos"];
-        entry.vbsModified = t["vbsModified"];
-        entry.iniModified = t["iniModified"];
-        entry.requiresPinmame = t.contains("requiresPinmame") ? t["requiresPinmame"].get<bool>() : false;
-        entry.gameName = t.contains("gameName") ? t["gameName"].get<std::string>() : "";
-        entry.lastRun = t.contains("lastRun") ? t["lastRun"].get<std::string>() : "clear";
-        entry.playCount = t.contains("playCount") ? t["playCount"].get<int>() : 0; // Load playCount
-        tables.push_back(entry);
-        LOG_DEBUG("Loaded from cache: " << entry.name << ", requiresPinmame=" << entry.requiresPinmame 
-                  << ", gameName=" << entry.gameName << ", rom=" << entry.rom << ", lastRun=" << entry.lastRun);
+    if (existing.empty()) return;
+    loadTables(existing, tables, previous, priority);
+    for (auto& entry : tables) {
+        entry.stamp = statFile(entry.filepath);
     }
 }
 
-void TableLoader::saveToCache(const std::string& jsonPath, const std::vector<TableEntry>& tables) {
-    json j;
-    j["last_updated"] = std::chrono::system_clock::now().time_since_epoch().count();
-    j["tables_hash"] = computeTablesHash(config.getTablesDir()); // Store hash for validation
-    for (const auto& t : tables) {
-        json tj;
-        tj["filepath"] = t.filepath;
-        tj["filename"] = t.filename;
-        tj["year"] = t.year;
-        tj["author"] = t.author;
-        tj["name"] = t.name;
-        tj["version"] = t.version;
-        tj["extraFiles"] = t.extraFiles;
-        tj["rom"] = t.rom;
-        tj["udmd"] = t.udmd;
-        tj["alts"] = t.alts;
-        tj["altc"] = t.altc;
-        tj["pup"] = t.pup;
-        tj["music"] = t.music;
-        tj["images"] = t.images;
-        tj["videos"] = t.videos;
-        tj["vbsModified"] = t.vbsModified;
-        tj["iniModified"] = t.iniModified;
-        tj["requiresPinmame"] = t.requiresPinmame;
-        tj["gameName"] = t.gameName;
-        tj["lastRun"] = t.lastRun;
-        tj["playCount"] = t.playCount; // Save playCount
-        j["tables"].push_back(tj);
+FileStamp TableLoader::statFile(const std::string& path) {
+    FileStamp stamp;
+    struct stat st;
+    if (stat(path.c_str(), &st) == 0) {
+        stamp.size = static_cast<uint64_t>(st.st_size);
+        stamp.mtime = static_cast<int64_t>(st.st_mtim.tv_sec) * 1000000000LL + st.st_mtim.tv_nsec;
+        stamp.inode = static_cast<uint64_t>(st.st_ino);
     }
-    std::ofstream file(jsonPath);
-    file << j.dump(2);
-    LOG_DEBUG("Saved " << tables.size() << " tables to cache: " << jsonPath << " with hash: " << j["tables_hash"]);
+    return stamp;
 }
 
-void TableLoader::generateIndex() {
-    std::string cmd = "\"" + config.getVpxTool() + "\" " + config.getIndexerSubCmd() + " \"" + config.getTablesDir() + "\"";
+bool TableLoader::folderModifiedSince(const std::string& vpxPath, const std::vector<std::string>& subdirs, long long since) {
+    std::string folder = std::filesystem::path(vpxPath).parent_path().string();
+    if (statFile(folder).mtime > since) return true;
+    // A missing subfolder stats as zero; creating or removing it touches its parent instead
+    for (const auto& dir : subdirs) {
+        if (statFile(folder + "/" + dir).mtime > since) return true;
+    }
+    return false;
+}
+
+void TableLoader::generateIndex(const std::string& dir) {
+    std::string cmd = "\"" + config.getVpxTool() + "\" " + config.getIndexerSubCmd() + " \"" + dir + "\"";
     LOG_DEBUG("Generating index with command: " << cmd);
     int result = system(cmd.c_str());
     if (result != 0) {
@@ -145,198 +152,207 @@ void TableLoader::generateIndex() {
     }
 }
 
-void TableLoader::loadTables(std::vector<TableEntry>& tables) {
+void TableLoader::loadTables(const std::vector<std::string>& vpxFiles, std::vector<TableEntry>& tables,
+                             const std::unordered_map<std::string, const TableEntry*>& previous, TaskPriority priority) {
     tables.clear();
-    std::string indexPath = config.getTablesDir() + "/" + config.getVpxtoolIndexFile();
-    if (!std::filesystem::exists(indexPath)) {
-        std::cerr << "Index file not found: " << indexPath << std::endl;
-        return;
+
+    // Carry lastRun and playCount over for tables being re-parsed; built once, read by every task
+    const UserStateSnapshot userState(previous);
+
+    std::vector<std::string> failed;
+    indexNative(vpxFiles, tables, failed, userState, priority);
+    if (!failed.empty()) {
+        LOG_DEBUG(failed.size() << " table(s) could not be read natively, falling back to vpxtool");
+        loadFromVpxtoolIndex(tables, failed, userState, priority);
     }
+    LOG_DEBUG("Indexed " << tables.size() << " of " << vpxFiles.size() << " tables");
+}
 
-    // Load existing cache to preserve lastRun
-    std::map<std::string, std::string> cachedLastRun;
-    std::string cachePath = config.getBasePath() + "resources/tables_index.json";
-    if (std::filesystem::exists(cachePath)) {
-        std::ifstream cacheFile(cachePath);
-        json j;
-        cacheFile >> j;
-        for (const auto& t : j["tables"]) {
-            if (t.contains("filepath") && t.contains("lastRun")) {
-                cachedLastRun[t["filepath"].get<std::string>()] = t["lastRun"].get<std::string>();
+std::vector<std::string> TableLoader::findVpxFiles(const std::string& dir) {
+    std::vector<std::string> files;
+    try {
+        for (const auto& entry : std::filesystem::recursive_directory_iterator(dir)) {
+            if (entry.is_regular_file() && entry.path().extension() == ".vpx") {
+                files.push_back(entry.path().string());
             }
         }
+    } catch (const std::filesystem::filesystem_error& e) {
+        LOG_DEBUG("Failed to scan tables dir " << dir << ": " << e.what());
     }
+    std::sort(files.begin(), files.end());
+    return files;
+}
 
-    std::ifstream file(indexPath);
-    json j;
-    file >> j;
-    auto& jt = j["tables"];
-    if (jt.empty()) {
-        LOG_DEBUG("No tables found in index: " << indexPath);
-        return;
-    }
-
-    const size_t numThreads = std::thread::hardware_concurrency();
-    const size_t chunkSize = jt.size() / numThreads + (jt.size() % numThreads != 0 ? 1 : 0);
-    std::vector<std::thread> threads;
-    std::vector<std::vector<TableEntry>> threadTables(numThreads);
+void TableLoader::indexNative(const std::vector<std::string>& vpxFiles, std::vector<TableEntry>& tables, std::vector<std::string>& failed,
+                              const UserStateSnapshot& userState, TaskPriority priority) {
+    std::vector<TableEntry> entries(vpxFiles.size());
+    std::vector<char> parsed(vpxFiles.size(), 0);
 
-    LOG_DEBUG("Parsing " << jt.size() << " tables with " << numThreads << " threads, chunk size=" << chunkSize);
-    for (size_t i = 0; i < numThreads; ++i) {
-        size_t start = i * chunkSize;
-        size_t end = std::min(start + chunkSize, jt.size());
-        if (start < end) {
-            threads.emplace_back(&TableLoader::parseTableChunk, this, std::ref(jt), std::ref(threadTables[i]), start, end, std::ref(cachedLastRun));
+    // One task per file, so a single huge table only ever occupies one worker
+    LOG_DEBUG("Reading " << vpxFiles.size() << " tables natively on " << ThreadPool::instance().size() << " pool threads");
+    ThreadPool::instance().parallelFor(vpxFiles.size(), [&](size_t i) {
+        VpxMetadata meta;
+        if (!VpxReader::readMetadata(vpxFiles[i], meta)) {
+            return;
         }
-    }
-
-    for (auto& t : threads) {
-        t.join();
-    }
+        TableEntry& entry = entries[i];
+        entry = buildEntry(vpxFiles[i], meta);
+        userState.applyTo(entry);
+        parsed[i] = 1;
+    }, priority);
 
-    for (const auto& chunk : threadTables) {
-        tables.insert(tables.end(), chunk.begin(), chunk.end());
+    for (size_t i = 0; i < vpxFiles.size(); ++i) {
+        if (parsed[i]) {
+            tables.push_back(std::move(entries[i]));
+        } else {
+            failed.push_back(vpxFiles[i]);
+        }
     }
-    LOG_DEBUG("Loaded " << tables.size() << " tables from index");
 }
 
-std::string TableLoader::computeTablesHash(const std::string& dir) {
-    std::string filenames;
-    try {
-        for (const auto& entry : std::filesystem::recursive_directory_iterator(dir)) {
-            if (entry.path().extension() == ".vpx") {
-                filenames += entry.path().filename().string(); // Concatenate .vpx filenames
-            }
+void TableLoader::loadFromVpxtoolIndex(std::vector<TableEntry>& tables, const std::vector<std::string>& paths, const UserStateSnapshot& userState,
+                                       TaskPriority priority) {
+    // vpxtool indexes whole directories, so only the folders holding the failed tables are indexed.
+    // A table that fails here too (e.g. still being copied) is left out and parsed again next pass.
+    std::set<std::string> folders;
+    for (const auto& p : paths) {
+        folders.insert(std::filesystem::path(p).parent_path().string());
+    }
+    std::vector<json> indexes;
+    indexes.reserve(folders.size());
+    for (const auto& folder : folders) {
+        generateIndex(folder);
+        std::string indexPath = folder + "/" + config.getVpxtoolIndexFile();
+        std::ifstream file(indexPath);
+        if (!file.is_open()) {
+            std::cerr << "Index file not found: " << indexPath << std::endl;
+            continue;
         }
-    } catch (const std::filesystem::filesystem_error& e) {
-        LOG_DEBUG("Failed to hash tables dir " << dir << ": " << e.what());
-        return "";
+        json j = json::parse(file, nullptr, false);
+        if (j.is_discarded() || !j.contains("tables") || !j["tables"].is_array()) {
+            std::cerr << "Failed to parse index file: " << indexPath << std::endl;
+            continue;
+        }
+        indexes.push_back(std::move(j));
     }
-    std::string hash = std::to_string(std::hash<std::string>{}(filenames));
-    LOG_DEBUG("Computed tables hash for " << dir << ": " << hash);
-    return hash;
-}
 
-// Extract words from a string, removing content in parentheses
-std::vector<std::string> extractWords(const std::string& s) {
-    std::string mainTitle = s.substr(0, s.find('('));
-    size_t end = mainTitle.find_last_not_of(' ');
-    if (end != std::string::npos) {
-        mainTitle = mainTitle.substr(0, end + 1);
-    } else {
-        mainTitle.clear();
+    // Selection bookkeeping only lives for this call: it comes from one arena, released in one step
+    std::pmr::monotonic_buffer_resource arena;
+    std::pmr::set<std::pmr::string, std::less<>> wanted(&arena);
+    for (const auto& p : paths) {
+        std::string normal = std::filesystem::path(p).lexically_normal().string();
+        wanted.emplace(normal.data(), normal.size());
     }
-    std::istringstream iss(mainTitle);
-    std::vector<std::string> words;
-    std::string word;
-    while (iss >> word) {
-        std::transform(word.begin(), word.end(), word.begin(), ::tolower);
-        words.push_back(word);
+    // Only keep the tables the native reader could not handle; rows are referenced, not copied
+    std::pmr::vector<const json*> jt(&arena);
+    for (const auto& j : indexes) {
+        for (const auto& t : j.at("tables")) {
+            auto path = t.find("path");
+            if (path == t.end() || !path->is_string()) continue;
+            const std::string& raw = path->get_ref<const std::string&>();
+            bool found = isLexicallyNormal(raw) ? wanted.count(std::string_view(raw)) > 0
+                                                : wanted.count(std::string_view(std::filesystem::path(raw).lexically_normal().string())) > 0;
+            if (found) jt.push_back(&t);
+        }
     }
-    return words;
-}
+    if (jt.empty()) {
+        LOG_DEBUG("No matching tables found in the vpxtool index of " << folders.size() << " folder(s)");
+        return;
+    }
+
+    // Chunks only read jt and the shared user-state snapshot, so they can be small: many tasks
+    // per worker let idle threads steal work when some tables parse slower than others
+    const size_t chunkSize = PARSE_CHUNK_ROWS;
+    const size_t numChunks = (jt.size() + chunkSize - 1) / chunkSize;
+    std::vector<std::vector<TableEntry>> threadTables(numChunks);
 
-// Check if two strings share at least one common word
-bool areSimilar(const std::string& s1, const std::string& s2) {
-    auto words1 = extractWords(s1);
-    auto words2 = extractWords(s2);
-    for (const auto& word : words1) {
-        if (std::find(words2.begin(), words2.end(), word) != words2.end()) {
-            return true;
+    LOG_DEBUG("Parsing " << jt.size() << " tables in " << numChunks << " chunks, chunk size=" << chunkSize);
+    ThreadPool::instance().parallelFor(numChunks, [&](size_t i) {
+        size_t start = i * chunkSize;
+        size_t end = std::min(start + chunkSize, jt.size());
+        if (start < end) {
+            parseTableChunk(jt, threadTables[i], start, end, userState);
         }
-    }
-    return false;
-}
+    }, priority);
 
-std::string extractYear(const std::string& s) {
-    std::regex yearPattern(R"(\b(19|20)\d{2}\b)");
-    std::smatch match;
-    if (std::regex_search(s, match, yearPattern)) {
-        return match.str();
+    tables.reserve(tables.size() + jt.size());
+    for (auto& chunk : threadTables) {
+        tables.insert(tables.end(), std::make_move_iterator(chunk.begin()), std::make_move_iterator(chunk.end()));
     }
-    return "";
 }
 
-std::string parseReleaseDate(const std::string& release) {
-    if (release.empty()) return "";
+// Builds a table entry from raw metadata, shared by the native reader and the vpxtool fallback
+TableEntry TableLoader::buildEntry(const std::string& filepath, const VpxMetadata& meta) {
+    TableEntry entry;
+    entry.filepath = filepath;
+    entry.filename = std::filesystem::path(entry.filepath).stem().string();
 
-    if (release.size() >= 10 && std::all_of(release.begin() + 6, release.begin() + 10, ::isdigit)) {
-        return release.substr(6, 4);
+    // Each name is scanned once; the parts point into meta and entry, which outlive them
+    NameParts fileParts = NameNormalizer::parse(entry.filename);
+    NameParts nameParts = NameNormalizer::parse(meta.tableName);
+    const bool useTableName = !meta.tableName.empty() && NameNormalizer::sharesWord(nameParts, fileParts);
+    entry.name = useTableName ? meta.tableName : entry.filename;
+    entry.author = !meta.authorName.empty() ? meta.authorName : "Unknown";
+    entry.year = NameNormalizer::releaseYear(meta.releaseDate);
+    if (entry.year.empty()) {
+        entry.year = std::string(fileParts.year); // Try filename first
+        if (entry.year.empty() && useTableName) {
+            entry.year = std::string(nameParts.year); // fallback to name, probably not a good idea.
+        }
+        if (entry.year.empty()) {
+            entry.year = "Unknown";
+        }
     }
-
-    std::regex shortDatePattern(R"(\b(\d{1,2})[/-](\d{1,2})[/-](\d{2})\b)");
-    std::smatch match;
-    if (std::regex_search(release, match, shortDatePattern) && match.size() == 4) {
-        std::string yearStr = match[3].str();
-        return (std::stoi(yearStr) <= 99) ? "19" + yearStr : yearStr;
+    if (entry.year == "Unknown" && !meta.releaseDate.empty()) {
+        LOG_DEBUG("Invalid release_date for " << entry.name << ": " << meta.releaseDate);
     }
+    entry.version = !meta.tableVersion.empty() ? meta.tableVersion : "Unknown";
+    entry.requiresPinmame = meta.requiresPinmame;
+    entry.gameName = meta.gameName;
 
-    return extractYear(release);
+    if (meta.tableName.empty()) LOG_DEBUG("Missing table_name for " << entry.filepath);
+    if (meta.authorName.empty()) LOG_DEBUG("Missing author_name for " << entry.name);
+    if (meta.releaseDate.empty()) LOG_DEBUG("Missing release_date for " << entry.name);
+    if (meta.tableVersion.empty()) LOG_DEBUG("Missing table_version for " << entry.name);
+    LOG_DEBUG("Indexed " << entry.name << ", manufacturer=" << (useTableName ? nameParts : fileParts).manufacturer
+              << ", requiresPinmame=" << entry.requiresPinmame << ", gameName=" << entry.gameName);
+    return entry;
 }
 
-void TableLoader::parseTableChunk(const json& jt, std::vector<TableEntry>& chunk, size_t start, size_t end, std::map<std::string, std::string>& cachedLastRun) {
-    std::map<std::string, int> cachedPlayCount;
-    std::string cachePath = config.getBasePath() + "resources/tables_index.json";
-    if (std::filesystem::exists(cachePath)) {
-        std::ifstream cacheFile(cachePath);
-        json j;
-        cacheFile >> j;
-        for (const auto& t : j["tables"]) {
-            if (t.contains("filepath") && t.contains("playCount")) {
-                cachedPlayCount[t["filepath"].get<std::string>()] = t["playCount"].get<int>();
-            }
-        }
-    }
+void TableLoader::parseTableChunk(const std::pmr::vector<const json*>& jt, std::vector<TableEntry>& chunk, size_t start, size_t end,
+                                  const UserStateSnapshot& userState) {
+    chunk.reserve(end - start);
     for (size_t i = start; i < end; ++i) {
-        const auto& t = jt[i];
-        TableEntry entry;
-        entry.filepath = t["path"].is_string() ? t["path"].get<std::string>() : "Unknown";
-        entry.filename = std::filesystem::path(entry.filepath).stem().string();
-
-        auto tableInfo = t["table_info"];
-        std::string tableName;
-        if (tableInfo["table_name"].is_string()) {
-            tableName = tableInfo["table_name"].get<std::string>();
-            if (!tableName.empty() && areSimilar(tableName, entry.filename)) {
-                entry.name = tableName;
-            } else {
-                entry.name = entry.filename;
-            }
-        } else {
-            entry.name = entry.filename;
-        }
-        entry.author = tableInfo["author_name"].is_string() ? tableInfo["author_name"].get<std::string>() : "Unknown";
-        std::string release = tableInfo["release_date"].is_string() ? tableInfo["release_date"].get<std::string>() : "";
-        entry.year = parseReleaseDate(release);
-        if (entry.year.empty()) {
-            entry.year = extractYear(entry.filename); // Try filename first
-            if (entry.year.empty()) {
-                entry.year = extractYear(entry.name); // fallback to name, probably not a good idea.
-                if (entry.year.empty()) {
-                    entry.year = "Unknown";
-                }
-            }
-        }
-        if (entry.year == "Unknown" && !release.empty()) {
-            LOG_DEBUG("Invalid release_date for " << entry.name << ": " << release);
-        }
-        entry.version = tableInfo["table_version"].is_string() ? tableInfo["table_version"].get<std::string>() : "Unknown";
+        const json& t = *jt[i];
+        // Fields are looked up without operator[], which would assert on a missing key
+        auto field = [](const json& object, const char* key) -> const json* {
+            auto it = object.find(key);
+            return it != object.end() ? &*it : nullptr;
+        };
+        const json* path = field(t, "path");
+        std::string filepath = path && path->is_string() ? path->get<std::string>() : "Unknown";
+        if (!path || !path->is_string()) LOG_DEBUG("Null path for table at index " << i);
 
-        entry.requiresPinmame = t["requires_pinmame"].is_boolean() ? t["requires_pinmame"].get<bool>() : false;
-        entry.gameName = t["game_name"].is_string() ? t["game_name"].get<std::string>() : "";
-        entry.lastRun = cachedLastRun.count(entry.filepath) ? cachedLastRun[entry.filepath] : "clear";
-        entry.playCount = cachedPlayCount.count(entry.filepath) ? cachedPlayCount[entry.filepath] : 0;
-        LOG_DEBUG("Parsed in thread " << std::this_thread::get_id() << ": " << entry.name 
-                  << ", requiresPinmame=" << entry.requiresPinmame << ", gameName=" << entry.gameName);
+        const json* tableInfo = field(t, "table_info");
+        auto infoString = [&](const char* key) {
+            const json* value = tableInfo ? field(*tableInfo, key) : nullptr;
+            return value && value->is_string() ? value->get<std::string>() : std::string();
+        };
+        VpxMetadata meta;
+        meta.tableName = infoString("table_name");
+        meta.authorName = infoString("author_name");
+        meta.releaseDate = infoString("release_date");
+        meta.tableVersion = infoString("table_version");
+        const json* requiresPinmame = field(t, "requires_pinmame");
+        meta.requiresPinmame = requiresPinmame && requiresPinmame->is_boolean() ? requiresPinmame->get<bool>() : false;
+        const json* gameName = field(t, "game_name");
+        meta.gameName = gameName && gameName->is_string() ? gameName->get<std::string>() : "";
+
+        TableEntry entry = buildEntry(filepath, meta);
+        userState.applyTo(entry);
         LOG_DEBUG("Parsed in thread " << std::this_thread::get_id() << ": " << entry.name 
                   << ", lastRun=" << entry.lastRun);
 
-        if (!t["path"].is_string()) LOG_DEBUG("Null path for table at " << entry.filepath);
-        if (!tableInfo["table_name"].is_string()) LOG_DEBUG("Null table_name for " << entry.filepath);
-        if (!tableInfo["author_name"].is_string()) LOG_DEBUG("Null author_name for " << entry.name);
-        if (!tableInfo["release_date"].is_string()) LOG_DEBUG("Null release_date for " << entry.name);
-        if (!tableInfo["table_version"].is_string()) LOG_DEBUG("Null table_version for " << entry.name);
-
-        chunk.push_back(entry);
+        chunk.push_back(std::move(entry));
     }
 }
\ No newline at end of file
@@ -3,11 +3,17 @@
 
 #include "utils/logging.h"
 #include "utils/structures.h"
+#include "utils/thread_pool.h"
 #include "config/iconfig_provider.h"
+#include "tables/vpx_reader.h"
+#include "tables/table_cache.h"
+#include "tables/user_state.h"
 #include <json.hpp>
 #include <vector>
 #include <filesystem>
 #include <string>
+#include <unordered_map>
+#include <memory_resource>
 
 using json = nlohmann::json;
 
@@ -16,43 +22,77 @@ public:
     // Constructor: Initializes with a config provider reference
     TableLoader(IConfigProvider& config);
 
-    // Loads table data into tables and filteredTables, with optional force re-indexing
+    // Loads table data into tables, re-indexing only .vpx files whose
+    // (size, mtime, inode) stamp differs from the cached manifest
     // tables: Vector to store loaded table entries
-    // filteredTables: Vector to store filtered table entries (initially same as tables)
+    // staleIndices: Receives indices into tables that need their file status re-probed
     // forceVpxToolIndex: If true, skips cache and regenerates index
-    void load(std::vector<TableEntry>& tables, std::vector<TableEntry>& filteredTables, bool forceVpxToolIndex = false);
+    // priority: Thread pool lane for the parsing tasks
+    void load(std::vector<TableEntry>& tables, std::vector<size_t>& staleIndices, bool forceVpxToolIndex = false,
+              TaskPriority priority = TaskPriority::Background);
+
+    // Parses the given .vpx files only, for targeted updates from the table watcher
+    // vpxFiles: Table paths to parse; paths that no longer exist are skipped
+    // tables: Receives the parsed entries, stamped with their current (size, mtime, inode)
+    // current: Existing rows for these paths, used to carry over lastRun and playCount
+    // priority: Thread pool lane for the parsing tasks
+    void reindex(const std::vector<std::string>& vpxFiles, std::vector<TableEntry>& tables, const std::vector<TableEntry>& current,
+                 TaskPriority priority = TaskPriority::Background);
+
+    // Reads size, mtime and inode for a file; zeroed stamp if stat fails
+    static FileStamp statFile(const std::string& path);
 
 private:
-    // Loads table data from cached JSON file
-    // jsonPath: Path to the cache file (tables_index.json)
-    // tables: Vector to populate with cached table entries
-    void loadFromCache(const std::string& jsonPath, std::vector<TableEntry>& tables);
 
-    // Saves table data to cached JSON file with timestamp and hash
-    // jsonPath: Path to save the cache file
-    // tables: Vector of table entries to save
-    void saveToCache(const std::string& jsonPath, const std::vector<TableEntry>& tables);
+    // Checks whether the folder holding a table, or one of its listed media/ROM subfolders,
+    // changed after the given time (ns since epoch); a file added to images/ only touches images/
+    // subdirs: FolderSnapshot::subdirectories() of the probe paths
+    static bool folderModifiedSince(const std::string& vpxPath, const std::vector<std::string>& subdirs, long long since);
 
-    // Generates table index using external vpxtool
-    void generateIndex();
+    // Generates a table index of dir using external vpxtool (fallback for tables the native reader rejects)
+    // dir: Directory to index; vpxtool writes its index file there
+    void generateIndex(const std::string& dir);
 
-    // Loads table data from vpxtool index file, parsing in parallel
+    // Indexes the given .vpx files, reading them natively in parallel
+    // vpxFiles: Table paths to parse
     // tables: Vector to populate with parsed table entries
-    void loadTables(std::vector<TableEntry>& tables);
+    // previous: Cached rows by path, used to carry over lastRun and playCount
+    void loadTables(const std::vector<std::string>& vpxFiles, std::vector<TableEntry>& tables,
+                    const std::unordered_map<std::string, const TableEntry*>& previous, TaskPriority priority);
+
+    // Recursively collects .vpx file paths, sorted for a stable table order
+    // dir: Directory path to scan
+    std::vector<std::string> findVpxFiles(const std::string& dir);
+
+    // Reads metadata straight from each .vpx, one thread pool task per file
+    // vpxFiles: Table paths to index
+    // tables: Vector to append successfully parsed entries to
+    // failed: Receives paths the native reader could not parse
+    // userState: lastRun and playCount to carry over, shared by all tasks
+    void indexNative(const std::vector<std::string>& vpxFiles, std::vector<TableEntry>& tables, std::vector<std::string>& failed,
+                     const UserStateSnapshot& userState, TaskPriority priority);
+
+    // Runs vpxtool index on the folders of the given tables and parses their JSON for those tables only
+    // tables: Vector to append parsed entries to
+    // paths: Table paths to take from the vpxtool index
+    // userState: lastRun and playCount to carry over, shared by all chunks
+    void loadFromVpxtoolIndex(std::vector<TableEntry>& tables, const std::vector<std::string>& paths, const UserStateSnapshot& userState,
+                              TaskPriority priority);
 
-    // Computes a hash of .vpx filenames in the tables directory for cache validation
-    // dir: Directory path to scan for .vpx files
-    // Returns: String hash of concatenated filenames
-    std::string computeTablesHash(const std::string& dir);
+    // Normalizes raw metadata (name similarity, year parsing, defaults) into a table entry
+    static TableEntry buildEntry(const std::string& filepath, const VpxMetadata& meta);
 
-    // Parses a chunk of JSON table data in a separate thread
-    // jt: JSON array of tables from index file
+    // Parses a chunk of vpxtool JSON table data in a separate thread
+    // jt: Selected tables of the parsed index file, pointing into its JSON document
     // chunk: Vector to store parsed table entries for this chunk
     // start: Starting index in jt for this chunk
     // end: Ending index in jt for this chunk
-    void parseTableChunk(const json& jt, std::vector<TableEntry>& chunk, size_t start, size_t end, std::map<std::string, std::string>& cachedLastRun);
+    // userState: lastRun and playCount to carry over; read-only, so chunks share it without locking
+    void parseTableChunk(const std::pmr::vector<const json*>& jt, std::vector<TableEntry>& chunk, size_t start, size_t end,
+                         const UserStateSnapshot& userState);
 
     IConfigProvider& config; // Reference to configuration provider
+    TableCache cache; // Binary table cache
 };
 
 #endif // TABLE_LOADER_H
\ No newline at end of file
@@ -1,143 +1,370 @@
 #include "tables/table_manager.h"
-#include <fstream>
 #include <filesystem>
+#include <unordered_map>
+#include <algorithm>
+#include <map>
+#include <set>
 
 TableManager::TableManager(IConfigProvider& config)
     : config(config), 
-      loading(false), 
       tablesLoaded(false),
       loader(config), 
-      updater(config, tablesMutex), 
-      filter() {}
+      updater(config, tablesMutex, dataVersion), 
+      filter(),
+      cache(config),
+      journal(config) {}
 
-bool TableManager::hasTablesDirChanged() const {
-    std::string tablesDir = config.getTablesDir();
-    std::string jsonPath = config.getBasePath() + "resources/tables_index.json";
-
-    if (!std::filesystem::exists(tablesDir) || !std::filesystem::exists(jsonPath)) {
-        return true; // If either doesn't exist, we need to refresh
+TableManager::~TableManager() {
+    updater.cancel();
+    {
+        std::lock_guard<std::mutex> lock(workerMutex);
+        stopping = true;
+    }
+    workerWake.notify_all();
+    if (worker.joinable()) {
+        worker.join();
     }
+    watcher.stop();
+}
 
-    // Find the most recent modification time of any subdirectory in tables/
-    long long mostRecentSubdirWrite = 0;
-    try {
-        for (const auto& entry : std::filesystem::directory_iterator(tablesDir)) {
-            if (entry.is_directory()) {
-                auto subdirLastWrite = std::filesystem::last_write_time(entry.path()).time_since_epoch().count();
-                if (subdirLastWrite > mostRecentSubdirWrite) {
-                    mostRecentSubdirWrite = subdirLastWrite;
-                }
+bool TableManager::loadTables() {
+    journal.load();
+    bool cached = false;
+    {
+        std::lock_guard<std::recursive_mutex> lock(tablesMutex);
+        long long lastUpdated = 0;
+        std::vector<TableEntry> cachedRows;
+        if (!tablesLoaded && cache.load(cachedRows, lastUpdated) && !cachedRows.empty()) {
+            tables.assign(cachedRows);
+            journal.apply(tables);
+            LOG_DEBUG("Showing " << tables.size() << " cached tables while revalidating (" << tables.memoryUsage() << " bytes)");
+            if (!searchIndex.load(cache.getSearchIndexPath(), tables)) {
+                searchIndex.build(tables);
             }
+            tablesLoaded = true;
+            ++dataVersion;
+            ++rowSetVersion;
+        }
+        cached = tablesLoaded;
+    }
+    // Without a cache the user is looking at the loading screen, so indexing is interactive work
+    startRevalidation(false, cached ? TaskPriority::Background : TaskPriority::Interactive);
+    return cached;
+}
+
+TableList TableManager::filterTables(const std::string& query) {
+    std::unique_lock<std::recursive_mutex> lock(tablesMutex);
+    filter.filterTables(tables, searchIndex, dataVersion, filteredOrder, query);
+    // Rebuilt only when the view changed, so finding the selected table stays O(1) per frame
+    if (positionsGeneration != filter.getGeneration() || filteredPositions.size() != tables.size()) {
+        filteredPositions.assign(tables.size(), TableList::npos);
+        for (size_t i = 0; i < filteredOrder.size(); ++i) {
+            filteredPositions[filteredOrder[i]] = i;
         }
-    } catch (const std::filesystem::filesystem_error& e) {
-        LOG_DEBUG("Error iterating tables directory " << tablesDir << ": " << e.what());
-        return true; // If we can't iterate, assume a change to be safe
+        positionsGeneration = filter.getGeneration();
     }
+    return TableList(std::move(lock), tables, filteredOrder, filteredPositions, dataVersion, rowSetVersion);
+}
 
-    std::ifstream file(jsonPath);
-    json j;
-    file >> j;
-    auto lastUpdated = j["last_updated"].get<long long>();
+void TableManager::setSortSpecs(const std::vector<SortSpec>& specs) {
+    filter.setSortSpecs(specs);
+}
 
-    return mostRecentSubdirWrite > lastUpdated;
+void TableManager::setFuzzySearch(bool enabled) {
+    filter.setFuzzy(enabled);
 }
 
-void TableManager::loadTables() {
-    if (!tablesLoaded) {
-        loader.load(tables, filteredTables);
-        tablesLoaded = true;
-        updateTablesAsync();
+void TableManager::updateTableLastRun(const std::string& filepath, const std::string& status) {
+    std::lock_guard<std::recursive_mutex> lock(tablesMutex);
+    size_t row = tables.find(filepath);
+    if (row == TableStore::npos) {
+        LOG_DEBUG("Table not found for filepath: " << filepath);
+        return;
+    }
+
+    int playCount = tables.playCount(row);
+    if (status == "success") {
+        playCount++; // Increment on success
     }
-    filter.filterTables(tables, filteredTables, "");
+    tables.setUserState(row, status, playCount);
+    ++dataVersion;
+    LOG_DEBUG("Updated table " << tables.name(row) << " (" << filepath << "): lastRun=" << status << ", playCount=" << playCount);
+
+    PlayState state;
+    state.lastRun = status;
+    state.playCount = playCount;
+    journal.record(filepath, state);
 }
 
-void TableManager::filterTables(const std::string& query) {
-    filter.filterTables(tables, filteredTables, query);
+void TableManager::refreshTables(bool forceFullRefresh) {
+    startRevalidation(forceFullRefresh, TaskPriority::Interactive);
 }
 
-void TableManager::setSortSpecs(int columnIdx, bool ascending) {
-    filter.setSortSpecs(columnIdx, ascending);
+void TableManager::startRevalidation(bool forceFullRefresh, TaskPriority priority) {
+    std::lock_guard<std::mutex> lock(workerMutex);
+    if (stopping) return;
+    if (refreshPending) {
+        LOG_DEBUG("Refresh already queued, merging request (force=" << forceFullRefresh << ")");
+    }
+    refreshPending = true;
+    refreshForced = refreshForced || forceFullRefresh;
+    if (priority == TaskPriority::Interactive) refreshPriority = priority;
+    refreshing = true;
+    if (!worker.joinable()) {
+        worker = std::thread(&TableManager::revalidationLoop, this);
+    } else {
+        workerWake.notify_one();
+    }
 }
 
-void TableManager::updateTablesAsync() {
-    updater.updateTablesAsync(tables, filteredTables, loading);
+void TableManager::revalidationLoop() {
+    std::unique_lock<std::mutex> lock(workerMutex);
+    while (true) {
+        workerWake.wait(lock, [this] { return refreshPending || stopping; });
+        if (stopping) break;
+        bool forceFullRefresh = refreshForced;
+        TaskPriority priority = refreshPriority;
+        refreshPending = false;
+        refreshForced = false;
+        refreshPriority = TaskPriority::Background;
+        lock.unlock();
+        revalidate(forceFullRefresh, priority);
+        lock.lock();
+        // A request made during the pass runs next instead of being dropped
+        if (!refreshPending) {
+            refreshing = false;
+            LOG_DEBUG("Revalidation finished, no refresh pending");
+        }
+    }
 }
 
-void TableManager::updateTableLastRun(const std::string& filepath, const std::string& status) {
-    std::lock_guard<std::mutex> lock(tablesMutex);
-    bool found = false;
-    
-    for (size_t i = 0; i < tables.size(); ++i) {
-        if (tables[i].filepath == filepath) {
-            tables[i].lastRun = status;
-            if (status == "success") {
-                tables[i].playCount++; // Increment on success
+void TableManager::revalidate(bool forceFullRefresh, TaskPriority priority) {
+    std::lock_guard<std::mutex> refreshLock(refreshMutex);
+    // Watch before scanning so nothing that changes during the scan is missed
+    if (!watcher.isRunning()) {
+        watcher.start(config.getTablesDir(), [this](const TableChanges& changes) { applyChanges(changes); });
+    }
+
+    // The loader's manifest picks up added, removed and modified tables on its own;
+    // a full refresh discards it and re-indexes everything
+    std::vector<TableEntry> fresh;
+    std::vector<size_t> staleIndices;
+    loader.load(fresh, staleIndices, forceFullRefresh, priority);
+
+    // Diff against the live rows: every row that is still there keeps the probe results it has on
+    // screen until it is re-probed (the updater redoes any check whose stamps no longer match), and
+    // a refresh that adds, removes and changes nothing leaves the store, the view and the search
+    // index untouched
+    bool changed = false;
+    {
+        std::lock_guard<std::recursive_mutex> lock(tablesMutex);
+        size_t matched = 0, added = 0, modified = 0;
+        for (auto& entry : fresh) {
+            size_t row = tables.find(entry.filepath);
+            if (row == TableStore::npos) {
+                ++added;
+                continue;
             }
-            LOG_DEBUG("Updated table " << tables[i].name << " (" << filepath << "): lastRun=" << status << ", playCount=" << tables[i].playCount);
-            found = true;
-            break;
+            ++matched;
+            if (!tables.sameIndexData(row, entry)) ++modified;
+            tables.getProbeResults(row, entry);
+        }
+        size_t removed = tables.size() - matched;
+        changed = !tablesLoaded || added > 0 || removed > 0 || modified > 0;
+        LOG_DEBUG("Refresh diff: " << added << " added, " << removed << " removed, " << modified << " changed");
+    }
+
+    if (changed) {
+        // Built off the lock, then swapped in as a whole, so a frame sees either set of rows, never a mix
+        TableStore freshStore;
+        freshStore.assign(fresh);
+        std::vector<TableEntry>().swap(fresh); // The store holds the rows from here on
+        SearchIndex freshIndex;
+        freshIndex.build(freshStore);
+        {
+            std::lock_guard<std::recursive_mutex> lock(tablesMutex);
+            // The cache may lag the journal, and launches recorded while indexing ran are newer
+            // still; they are recorded under this lock, so none is missed
+            journal.apply(freshStore);
+            std::swap(tables, freshStore);
+            searchIndex = std::move(freshIndex);
+            tablesLoaded = true;
+            ++dataVersion;
+            ++rowSetVersion;
         }
+        // Only this thread replaces the index (refreshMutex), so it can be written without the table lock
+        searchIndex.save(cache.getSearchIndexPath());
     }
-    
-    for (size_t i = 0; i < filteredTables.size(); ++i) {
-        if (filteredTables[i].filepath == filepath) {
-            filteredTables[i].lastRun = status;
-            if (status == "success") {
-                filteredTables[i].playCount++;
+    // Unchanged rows are in the same filepath order as fresh, so staleIndices apply either way
+    updater.updateTables(tables, staleIndices, PROBE_ALL, priority);
+
+    // An edited VPinballX.ini changes every table's overrides without touching any table folder
+    FileStamp baseIniStamp = TableLoader::statFile(config.getVPinballXIni());
+    std::vector<size_t> iniIndices;
+    {
+        std::lock_guard<std::recursive_mutex> lock(tablesMutex);
+        for (size_t i = 0; i < tables.size(); ++i) {
+            if ((tables.status(i) & STATUS_INI) && tables.stamps(i).iniBaseStamp != baseIniStamp) {
+                iniIndices.push_back(i);
             }
-            break;
         }
     }
-    
-    if (!found) {
-        LOG_DEBUG("Table not found for filepath: " << filepath);
+    updater.updateTables(tables, iniIndices, PROBE_INI, priority);
+
+    // One cache write per pass, after parsing and probing are both done
+    if (changed || !staleIndices.empty() || !iniIndices.empty()) {
+        saveToCache();
+    }
+}
+
+void TableManager::applyChanges(const TableChanges& changes) {
+    if (changes.overflow) {
+        LOG_DEBUG("Watcher lost events, revalidating the whole library");
+        startRevalidation(false, TaskPriority::Background);
         return;
     }
-    
-    saveToCache();
+
+    std::lock_guard<std::mutex> refreshLock(refreshMutex);
+    applyingChanges = true;
+    const std::string indexFile = config.getVpxtoolIndexFile();
+    std::set<std::string> vpxFiles;
+    std::map<std::string, uint32_t> folderProbes;
+    {
+        std::lock_guard<std::recursive_mutex> lock(tablesMutex);
+        std::unordered_map<std::string, bool> tableFolders;
+        for (size_t i = 0; i < tables.size(); ++i) {
+            tableFolders[tables.folder(i)] = true;
+        }
+        for (const auto& path : changes.paths) {
+            std::filesystem::path changed(path);
+            if (changed.extension() == ".vpx") {
+                vpxFiles.insert(path);
+                continue;
+            }
+            if (changed.filename() == indexFile) continue; // Written by vpxtool index
+            // A folder moved or deleted as a whole takes its tables with it; rows are sorted by path
+            if (!std::filesystem::exists(changed)) {
+                const std::string prefix = path + "/";
+                for (size_t row = tables.lowerBound(prefix); row < tables.size(); ++row) {
+                    std::string filepath = tables.filepath(row);
+                    if (filepath.compare(0, prefix.size(), prefix) != 0) break;
+                    vpxFiles.insert(filepath);
+                }
+            }
+            for (auto dir = changed.parent_path(); !dir.empty() && dir != dir.root_path(); dir = dir.parent_path()) {
+                if (tableFolders.count(dir.string())) {
+                    folderProbes[dir.string()] |= probesForPath(dir.string(), path);
+                    break;
+                }
+            }
+        }
+    }
+
+    bool rowsChanged = false;
+    if (!vpxFiles.empty()) {
+        std::vector<std::string> paths(vpxFiles.begin(), vpxFiles.end());
+        std::vector<TableEntry> current;
+        TableStore edited;
+        {
+            std::lock_guard<std::recursive_mutex> lock(tablesMutex);
+            for (const auto& path : paths) {
+                size_t row = tables.find(path);
+                if (row != TableStore::npos) current.push_back(tables.get(row));
+            }
+            edited = tables; // Plain column copies; everything below runs on it without the lock
+        }
+        std::vector<TableEntry> parsed;
+        loader.reindex(paths, parsed, current);
+        // Re-parsed rows show their old status until the re-probe below replaces it
+        for (auto& entry : parsed) {
+            size_t row = edited.find(entry.filepath);
+            if (row != TableStore::npos) edited.getProbeResults(row, entry);
+        }
+
+        // Edits are applied to materialized rows, then the store is rebuilt and compacted; like in
+        // revalidate(), the rebuilt store and index are swapped in whole, so frames never wait on it
+        std::vector<TableEntry> rows = edited.toEntries();
+        size_t before = rows.size();
+        rows.erase(std::remove_if(rows.begin(), rows.end(), [&](const TableEntry& entry) {
+            return vpxFiles.count(entry.filepath) && !std::filesystem::exists(entry.filepath);
+        }), rows.end());
+        const bool removed = rows.size() != before;
+        if (removed || !parsed.empty()) {
+            rowsChanged = true;
+            for (auto& entry : parsed) {
+                folderProbes[std::filesystem::path(entry.filepath).parent_path().string()] = PROBE_ALL;
+                auto it = std::lower_bound(rows.begin(), rows.end(), entry.filepath, [](const TableEntry& row, const std::string& path) {
+                    return row.filepath < path;
+                });
+                if (it != rows.end() && it->filepath == entry.filepath) {
+                    *it = std::move(entry);
+                } else {
+                    rows.insert(it, std::move(entry));
+                }
+            }
+            LOG_DEBUG("Watcher re-indexed " << parsed.size() << " table(s), removed " << (before + parsed.size() - rows.size()));
+            edited.assign(rows);
+            std::vector<TableEntry>().swap(rows);
+            SearchIndex editedIndex;
+            editedIndex.build(edited);
+            {
+                std::lock_guard<std::recursive_mutex> lock(tablesMutex);
+                // Launches recorded since the copy was taken only reached the live rows and the journal
+                journal.apply(edited);
+                std::swap(tables, edited);
+                searchIndex = std::move(editedIndex);
+                ++dataVersion;
+                ++rowSetVersion;
+            }
+            searchIndex.save(cache.getSearchIndexPath());
+        }
+    }
+
+    // Rows sharing a probe set are updated together
+    std::map<uint32_t, std::vector<size_t>> rowsByProbes;
+    {
+        std::lock_guard<std::recursive_mutex> lock(tablesMutex);
+        for (size_t i = 0; i < tables.size(); ++i) {
+            auto it = folderProbes.find(tables.folder(i));
+            if (it != folderProbes.end()) rowsByProbes[it->second].push_back(i);
+        }
+    }
+    for (const auto& [probes, indices] : rowsByProbes) {
+        LOG_DEBUG("Watcher re-probing " << indices.size() << " table(s), probes=0x" << std::hex << probes << std::dec);
+        updater.updateTables(tables, indices, probes);
+    }
+    if (rowsChanged || !rowsByProbes.empty()) {
+        saveToCache();
+    }
+    applyingChanges = false;
 }
 
-void TableManager::refreshTables(bool forceFullRefresh) {
-    std::lock_guard<std::mutex> lock(tablesMutex);
-    bool forceVpxToolIndex = forceFullRefresh || hasTablesDirChanged();
-    tablesLoaded = false; // Force reload
-    tables.clear();
-    filteredTables.clear();
-    loader.load(tables, filteredTables, forceVpxToolIndex); // Pass forceVpxToolIndex to loader
-    tablesLoaded = true;
-    updateTablesAsync();
+uint32_t TableManager::probesForPath(const std::string& folder, const std::string& path) const {
+    std::string rel = path.substr(std::min(path.size(), folder.size() + 1));
+    if (rel.find('/') == std::string::npos) {
+        std::string ext = std::filesystem::path(rel).extension().string();
+        std::transform(ext.begin(), ext.end(), ext.begin(), ::tolower);
+        if (ext == ".vbs") return PROBE_SIDECARS | PROBE_VBS;
+        if (ext == ".ini") return PROBE_SIDECARS | PROBE_INI;
+        if (ext == ".directb2s") return PROBE_SIDECARS;
+    }
+    std::string romDir = config.getRomPath();
+    while (!romDir.empty() && romDir.front() == '/') romDir.erase(0, 1);
+    if (!romDir.empty() && rel.compare(0, romDir.size(), romDir) == 0) {
+        return PROBE_ROM;
+    }
+    if (!romDir.empty() && romDir.compare(0, rel.size() + 1, rel + "/") == 0) {
+        // A parent of the ROM folder (e.g. a new pinmame/) may also hold AltSound or AltColor
+        return PROBE_ROM | PROBE_MEDIA;
+    }
+    return PROBE_MEDIA;
 }
 
 void TableManager::saveToCache() {
-    std::string jsonPath = config.getBasePath() + "resources/tables_index.json";
-    json j;
-    j["last_updated"] = std::chrono::system_clock::now().time_since_epoch().count();
-    for (const auto& t : tables) {
-        json tj;
-        tj["filepath"] = t.filepath;
-        tj["filename"] = t.filename;
-        tj["year"] = t.year;
-        tj["author"] = t.author;
-        tj["name"] = t.name;
-        tj["version"] = t.version;
-        tj["extraFiles"] = t.extraFiles;
-        tj["rom"] = t.rom;
-        tj["udmd"] = t.udmd;
-        tj["alts"] = t.alts;
-        tj["altc"] = t.altc;
-        tj["pup"] = t.pup;
-        tj["music"] = t.music;
-        tj["images"] = t.images;
-        tj["videos"] = t.videos;
-        tj["vbsModified"] = t.vbsModified;
-        tj["iniModified"] = t.iniModified;
-        tj["requiresPinmame"] = t.requiresPinmame;
-        tj["gameName"] = t.gameName;
-        tj["lastRun"] = t.lastRun;
-        tj["playCount"] = t.playCount;
-        j["tables"].push_back(tj);
-    }
-    std::ofstream file(jsonPath);
-    file << j.dump(2);
-    LOG_DEBUG("Saved " << tables.size() << " tables to cache: " << jsonPath);
+    TableStore snapshot;
+    {
+        std::lock_guard<std::recursive_mutex> lock(tablesMutex);
+        snapshot = tables;
+    }
+    cache.save(snapshot.toEntries());
 }
\ No newline at end of file
@@ -6,35 +6,93 @@
 #include "tables/table_loader.h"
 #include "tables/table_updater.h"
 #include "tables/table_filter.h"
+#include "tables/table_list.h"
+#include "tables/table_store.h"
+#include "tables/search_index.h"
+#include "tables/table_cache.h"
+#include "tables/table_watcher.h"
+#include "tables/play_journal.h"
 #include <vector>
 #include <string>
 #include <mutex>
+#include <atomic>
+#include <thread>
+#include <condition_variable>
 
 class TableManager {
 public:
     TableManager(IConfigProvider& config);
-    void loadTables();
-    void filterTables(const std::string& query);
-    void setSortSpecs(int columnIdx, bool ascending);
-    void updateTablesAsync();
-    void updateTableLastRun(const std::string& filepath, const std::string& status); // Replace size_t index version
+    ~TableManager();
+
+    // Shows the cached library right away and revalidates it in the background
+    // Returns: true if the cache held rows that can be drawn on the first frame
+    bool loadTables();
+    // Filters and sorts the library for the current frame
+    // query: Search text from the launcher
+    // Returns: View over the matching rows; it holds the table lock, so drop it before the frame ends
+    TableList filterTables(const std::string& query);
+    void setSortSpecs(const std::vector<SortSpec>& specs); // Most significant first
+    void setFuzzySearch(bool enabled); // Ranked fuzzy matching instead of substring search
+    // Records a launch in the play journal; the table cache is not rewritten
+    // status: "success" also counts a play, "failed" or "clear" only set lastRun
+    void updateTableLastRun(const std::string& filepath, const std::string& status);
     void refreshTables(bool forceFullRefresh = false); // Modified to accept forceFullRefresh
 
-    std::vector<TableEntry>& getTables() { return filteredTables; }
-    bool isLoading() const { return loading; }
+    bool isLoading() const { return refreshing || applyingChanges; } // Background revalidation queued or running
+    bool isReady() const { return tablesLoaded; } // Rows from the cache or a first index are available
 
 private:
-    bool hasTablesDirChanged() const; // New method to check if tables/ folder has changed
+    // Queues a revalidation on the worker thread, starting the thread on first use. Requests made
+    // while one is queued or running are merged into one more pass: forced if any of them was,
+    // interactive if any of them was. Never waits for the worker, so it is safe from the UI thread.
+    void startRevalidation(bool forceFullRefresh, TaskPriority priority);
+
+    // Worker thread body: runs revalidate() for each queued request until the manager is destroyed
+    void revalidationLoop();
+
+    // Re-indexes changed files and re-probes stale rows; runs on the worker thread
+    // forceFullRefresh: Ignores the cache and re-indexes every table
+    // priority: Thread pool lane for the parsing and probing tasks
+    void revalidate(bool forceFullRefresh, TaskPriority priority);
+
+    // Turns a batch of watcher events into targeted updates: changed .vpx files are
+    // re-parsed, other paths re-probe only the checks they can affect for their table
+    void applyChanges(const TableChanges& changes);
+
+    // Picks the ProbeFlags a changed path inside a table folder can affect
+    // folder: Table folder the path belongs to
+    // path: Changed file or directory below folder
+    uint32_t probesForPath(const std::string& folder, const std::string& path) const;
+
+    // Writes the rows to the table cache; the table lock is only held while they are copied.
+    // Callers hold refreshMutex, which serializes every cache write.
     void saveToCache();
     IConfigProvider& config;
-    std::vector<TableEntry> tables;
-    std::vector<TableEntry> filteredTables;
-    bool loading;
-    bool tablesLoaded;
-    std::mutex tablesMutex;
+    TableStore tables; // Guarded by tablesMutex
+    std::vector<size_t> filteredOrder; // Indices into tables for the current filter and sort
+    std::vector<size_t> filteredPositions; // Inverse of filteredOrder, TableList::npos for filtered-out rows
+    uint64_t positionsGeneration = 0; // TableFilter generation filteredPositions was built for
+    SearchIndex searchIndex; // Trigram index over tables; rebuilt whenever rows are added, removed or replaced
+    std::atomic<bool> refreshing{false}; // A revalidation is queued or running
+    std::atomic<bool> applyingChanges{false}; // The watcher is applying a batch
+    std::atomic<bool> tablesLoaded;
+    std::atomic<uint64_t> dataVersion{0}; // Bumped on every change to tables; drives filter memoization
+    std::atomic<uint64_t> rowSetVersion{0}; // Bumped only when tables is replaced; the view re-anchors its scroll on it
+    std::recursive_mutex tablesMutex; // Recursive: the UI thread updates rows while it holds a TableList
+    std::mutex refreshMutex; // Serializes revalidation and watcher updates
     TableLoader loader;
     TableUpdater updater;
     TableFilter filter;
+    TableCache cache;
+    PlayJournal journal; // Authoritative lastRun/playCount, applied over every set of rows loaded
+    TableWatcher watcher; // Live updates for TablesDir
+    std::mutex workerMutex; // Guards the request fields below
+    std::condition_variable workerWake;
+    bool refreshPending = false; // Set by startRevalidation(), taken by the worker before each pass
+    bool refreshForced = false; // A pending request asked for a full refresh
+    TaskPriority refreshPriority = TaskPriority::Background; // Interactive if a pending request was
+    bool stopping = false; // Set by the destructor; the worker exits instead of starting a pass
+    std::thread worker; // Runs revalidationLoop() from the first refresh until destruction
 };
 
 #endif // TABLE_MANAGER_H
\ No newline at end of file
@@ -0,0 +1,201 @@
+#include "tables/table_query.h"
+#include "tables/search_index.h"
+#include "tables/sort_keys.h"
+#include <algorithm>
+#include <climits>
+
+namespace {
+
+const size_t SELECTIVITY_SAMPLE = 256; // Rows tested per predicate when ordering the pipeline
+
+// One field of a "first<sep>second" search key
+inline std::string_view keyField(std::string_view key, bool second) {
+    size_t sep = key.find(SearchIndex::KEY_SEPARATOR);
+    if (!second) return key.substr(0, sep);
+    return sep == std::string_view::npos ? std::string_view() : key.substr(sep + 1);
+}
+
+// Parses a plain run of up to 9 digits; value is left alone if text is anything else
+bool parseNumber(std::string_view text, long& value) {
+    if (text.empty() || text.size() > 9) return false;
+    long result = 0;
+    for (char c : text) {
+        if (c < '0' || c > '9') return false;
+        result = result * 10 + (c - '0');
+    }
+    value = result;
+    return true;
+}
+
+} // namespace
+
+TableQuery::TableQuery(const std::string& foldedQuery) {
+    std::vector<std::string_view> words;
+    std::string_view query(foldedQuery);
+    size_t pos = 0;
+    while (pos < query.size()) {
+        if (query[pos] == ' ') {
+            ++pos;
+            continue;
+        }
+        const size_t start = pos;
+        size_t end = pos;
+        size_t colon = std::string_view::npos;
+        while (end < query.size() && query[end] != ' ') {
+            if (query[end] == ':' && colon == std::string_view::npos) {
+                colon = end;
+                // A quoted value runs to the closing quote, spaces included
+                if (end + 1 < query.size() && query[end + 1] == '"') {
+                    size_t close = query.find('"', end + 2);
+                    end = close == std::string_view::npos ? query.size() : close + 1;
+                    break;
+                }
+            }
+            ++end;
+        }
+        std::string_view word = query.substr(start, end - start);
+        pos = end;
+
+        Predicate predicate;
+        bool compiled = false;
+        if (word == "failed") {
+            predicate.field = Field::Failed;
+            compiled = true;
+        } else if (colon != std::string_view::npos) {
+            std::string_view field = word.substr(0, colon - start);
+            std::string_view value = word.substr(field.size() + 1);
+            if (!value.empty() && value.front() == '"') {
+                value.remove_prefix(1);
+                if (!value.empty() && value.back() == '"') value.remove_suffix(1);
+            }
+            compiled = compile(field, value, predicate);
+        }
+        if (compiled) {
+            predicates.push_back(std::move(predicate));
+        } else {
+            words.push_back(word);
+        }
+    }
+
+    if (predicates.empty()) {
+        text = foldedQuery; // Plain search, matched exactly as typed
+    } else {
+        for (std::string_view word : words) {
+            if (!text.empty()) text += ' ';
+            text.append(word.data(), word.size());
+        }
+    }
+}
+
+bool TableQuery::compile(std::string_view field, std::string_view value, Predicate& predicate) {
+    if (value.empty()) return false;
+    if (field == "author" || field == "rom") {
+        predicate.field = field == "author" ? Field::Author : Field::Rom;
+        predicate.text.assign(value.data(), value.size());
+        predicate.cost = 4;
+        return true;
+    }
+    if (field == "year" || field == "played") {
+        predicate.field = field == "year" ? Field::Year : Field::Played;
+        predicate.cost = field == "year" ? 2 : 1;
+        return parseRange(value, predicate.low, predicate.high);
+    }
+    if (field == "has" || field == "missing" || field == "modified") {
+        if (!parseItem(value, predicate.item)) return false;
+        if (field == "modified") {
+            // Only the .ini and .vbs are compared against a reference
+            if (predicate.item != STATUS_INI && predicate.item != STATUS_VBS) return false;
+            predicate.field = Field::Modified;
+        } else {
+            predicate.field = field == "has" ? Field::Has : Field::Missing;
+        }
+        predicate.cost = 2;
+        return true;
+    }
+    return false;
+}
+
+bool TableQuery::parseRange(std::string_view value, long& low, long& high) {
+    low = 0;
+    high = LONG_MAX;
+    size_t dots = value.find("..");
+    if (dots != std::string_view::npos) {
+        std::string_view from = value.substr(0, dots);
+        std::string_view to = value.substr(dots + 2);
+        if (from.empty() && to.empty()) return false;
+        if (!from.empty() && !parseNumber(from, low)) return false;
+        if (!to.empty() && !parseNumber(to, high)) return false;
+        return low <= high;
+    }
+    long number = 0;
+    if (value.rfind(">=", 0) == 0) {
+        if (!parseNumber(value.substr(2), number)) return false;
+        low = number;
+    } else if (value.rfind("<=", 0) == 0) {
+        if (!parseNumber(value.substr(2), number)) return false;
+        high = number;
+    } else if (value.front() == '>') {
+        if (!parseNumber(value.substr(1), number)) return false;
+        low = number + 1;
+    } else if (value.front() == '<') {
+        if (!parseNumber(value.substr(1), number) || number == 0) return false;
+        high = number - 1;
+    } else {
+        if (!parseNumber(value, number)) return false;
+        low = high = number;
+    }
+    return true;
+}
+
+bool TableQuery::parseItem(std::string_view value, uint32_t& item) {
+    for (size_t bit = 0; bit < TABLE_STATUS_COUNT; ++bit) {
+        if (value == TABLE_STATUS_NAMES[bit]) {
+            item = 1u << bit;
+            return true;
+        }
+    }
+    return false;
+}
+
+void TableQuery::orderBySelectivity(const TableStore& tables) {
+    if (predicates.size() < 2 || tables.empty()) return;
+    const size_t step = std::max<size_t>(1, tables.size() / SELECTIVITY_SAMPLE);
+    for (auto& predicate : predicates) {
+        predicate.passed = 0;
+        for (size_t row = 0; row < tables.size(); row += step) {
+            if (test(predicate, tables, row)) ++predicate.passed;
+        }
+    }
+    // Fewest survivors first; between equally selective predicates the cheaper one runs first
+    std::stable_sort(predicates.begin(), predicates.end(), [](const Predicate& a, const Predicate& b) {
+        if (a.passed != b.passed) return a.passed < b.passed;
+        return a.cost < b.cost;
+    });
+}
+
+bool TableQuery::matches(const TableStore& tables, size_t row) const {
+    for (const auto& predicate : predicates) {
+        if (!test(predicate, tables, row)) return false;
+    }
+    return true;
+}
+
+bool TableQuery::test(const Predicate& predicate, const TableStore& tables, size_t row) {
+    switch (predicate.field) {
+        case Field::Author: return keyField(tables.fuzzyKey(row), false).find(predicate.text) != std::string_view::npos;
+        case Field::Rom: return keyField(tables.fuzzyKey(row), true).find(predicate.text) != std::string_view::npos;
+        case Field::Year: {
+            long year = SortKeys::parseYear(tables.year(row));
+            return year >= 0 && year >= predicate.low && year <= predicate.high;
+        }
+        case Field::Played: return tables.playCount(row) >= predicate.low && tables.playCount(row) <= predicate.high;
+        case Field::Has: return (tables.status(row) & predicate.item) != 0;
+        case Field::Missing:
+            // A table that runs without PinMAME is not missing a ROM
+            if (predicate.item == STATUS_ROM && !tables.requiresPinmame(row)) return false;
+            return (tables.status(row) & predicate.item) == 0;
+        case Field::Modified: return predicate.item == STATUS_INI ? tables.iniModified(row) : tables.vbsModified(row);
+        case Field::Failed: return tables.failed(row);
+    }
+    return false;
+}
\ No newline at end of file
@@ -0,0 +1,66 @@
+#ifndef TABLE_QUERY_H
+#define TABLE_QUERY_H
+
+#include "tables/table_store.h"
+#include <string>
+#include <string_view>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+// Search box query compiled into free text plus a pipeline of field predicates. Recognized tokens:
+//   author:<text>  rom:<text>      Folded substring of the author / ROM name ("author:\"jp salas\"")
+//   year:<range>   played:<range>  Release year / play count: N, >N, >=N, <N, <=N, A..B, A.., ..B
+//   has:<item>     missing:<item>  ini vbs b2s rom udmd altsound altcolor pup music wheel table
+//                                  backglass marquee tablevideo b2svideo dmdvideo
+//   modified:ini   modified:vbs    Table .ini overrides settings / sidecar .vbs differs from the table
+//   failed                         The last launch failed
+// Any other word, including an unknown or incomplete field:value, stays free text.
+class TableQuery {
+public:
+    // foldedQuery: Query passed through SearchIndex::fold()
+    explicit TableQuery(const std::string& foldedQuery);
+
+    bool hasPredicates() const { return !predicates.empty(); }
+
+    // Free text left after removing the predicates, matched as a substring like a plain search.
+    // Without predicates this is the query itself; otherwise the remaining words joined by spaces.
+    const std::string& getText() const { return text; }
+
+    // Moves the predicates most likely to reject a row to the front, using their pass rate
+    // on an evenly spaced sample of tables
+    void orderBySelectivity(const TableStore& tables);
+
+    // Tests the predicates in order, stopping at the first one the row fails
+    bool matches(const TableStore& tables, size_t row) const;
+
+private:
+    enum class Field { Author, Rom, Year, Played, Has, Missing, Modified, Failed };
+
+    struct Predicate {
+        Field field = Field::Failed;
+        std::string text; // Author, Rom
+        long low = 0;     // Year, Played: inclusive range
+        long high = 0;
+        uint32_t item = 0;     // Has, Missing, Modified: one TableStatus bit
+        int cost = 1;          // Relative evaluation cost, breaks selectivity ties
+        size_t passed = 0;     // Sample rows that passed, set by orderBySelectivity()
+    };
+
+    // Compiles one "field:value" token
+    // Returns: false if the field is unknown or the value does not parse
+    static bool compile(std::string_view field, std::string_view value, Predicate& predicate);
+
+    // Parses N, >N, >=N, <N, <=N, A..B, A.. or ..B into an inclusive range
+    static bool parseRange(std::string_view value, long& low, long& high);
+
+    // Looks up a TABLE_STATUS_NAMES entry
+    static bool parseItem(std::string_view value, uint32_t& item);
+
+    static bool test(const Predicate& predicate, const TableStore& tables, size_t row);
+
+    std::vector<Predicate> predicates;
+    std::string text;
+};
+
+#endif // TABLE_QUERY_H
\ No newline at end of file
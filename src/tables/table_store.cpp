@@ -0,0 +1,292 @@
+#include "tables/table_store.h"
+#include "tables/search_index.h"
+
+const char* const TableStore::LAST_RUN_NAMES[3] = {"clear", "success", "failed"};
+
+void TableStore::assign(const std::vector<TableEntry>& rows) {
+    clear();
+    const size_t count = rows.size();
+    // Upper bound: the whole path, a name of its own and a search key as long as both names
+    size_t arenaSize = 0;
+    for (const auto& entry : rows) {
+        arenaSize += entry.filepath.size() + entry.name.size() * 2 + entry.filename.size() + 1;
+    }
+    arena.reserve(arenaSize);
+    dirs.resize(count);
+    tails.resize(count);
+    filenames.resize(count);
+    names.resize(count);
+    searchKeys.resize(count);
+    years.resize(count);
+    authors.resize(count);
+    versions.resize(count);
+    gameNames.resize(count);
+    fuzzyKeys.resize(count);
+    overrides.resize(count);
+    statuses.resize(count);
+    flags.resize(count);
+    lastRuns.resize(count);
+    playCounts.resize(count);
+    indexStamps.resize(count);
+    probeStampIds.resize(count);
+    ids.resize(count);
+    rowById.reserve(count);
+
+    for (size_t i = 0; i < count; ++i) {
+        const TableEntry& entry = rows[i];
+        // Split "<dir>/<table folder>/<file>.vpx" after <dir>/, which most rows share
+        std::string_view path(entry.filepath);
+        size_t slash = path.rfind('/');
+        size_t dirEnd = 0;
+        if (slash != std::string_view::npos) {
+            size_t parent = slash > 0 ? path.rfind('/', slash - 1) : std::string_view::npos;
+            dirEnd = (parent != std::string_view::npos ? parent : slash) + 1;
+        }
+        dirs[i] = pool.intern(path.substr(0, dirEnd));
+        tails[i] = append(path.substr(dirEnd));
+        // The stem is the file name minus its extension for every indexed table
+        size_t leafStart = slash == std::string_view::npos ? 0 : slash + 1 - dirEnd;
+        std::string_view leaf = span(tails[i]).substr(leafStart);
+        filenames[i] = leaf.compare(0, entry.filename.size(), entry.filename) == 0
+                           ? Span{static_cast<uint32_t>(tails[i].offset + leafStart), static_cast<uint32_t>(entry.filename.size())}
+                           : append(entry.filename);
+        names[i] = entry.name == entry.filename ? filenames[i] : append(entry.name);
+        searchKeys[i] = append(SearchIndex::makeSearchKey(entry.name, entry.filename));
+        years[i] = pool.intern(entry.year);
+        authors[i] = pool.intern(entry.author);
+        versions[i] = pool.intern(entry.version);
+        gameNames[i] = pool.intern(entry.gameName);
+        fuzzyKeys[i] = pool.intern(SearchIndex::makeFuzzyKey(entry.author, entry.gameName));
+        overrides[i] = internOverrides(entry.iniOverrides);
+        statuses[i] = entry.status;
+        flags[i] = flagsOf(entry);
+        lastRuns[i] = lastRunCode(entry.lastRun);
+        playCounts[i] = entry.playCount;
+        indexStamps[i] = entry.stamp;
+        setProbeStamps(i, entry);
+        ids[i] = tableIdOf(entry.filepath);
+        rowById.emplace(ids[i], i);
+    }
+    arena.shrink_to_fit();
+    probeStamps.shrink_to_fit();
+}
+
+void TableStore::clear() {
+    pool.clear();
+    // Shrink as well, so a smaller library gives its memory back
+    std::string().swap(arena);
+    std::vector<uint32_t>().swap(dirs);
+    std::vector<Span>().swap(tails);
+    std::vector<Span>().swap(filenames);
+    std::vector<Span>().swap(names);
+    std::vector<Span>().swap(searchKeys);
+    std::vector<uint32_t>().swap(years);
+    std::vector<uint32_t>().swap(authors);
+    std::vector<uint32_t>().swap(versions);
+    std::vector<uint32_t>().swap(gameNames);
+    std::vector<uint32_t>().swap(fuzzyKeys);
+    std::vector<uint32_t>().swap(overrides);
+    std::vector<uint32_t>().swap(statuses);
+    std::vector<uint8_t>().swap(flags);
+    std::vector<uint8_t>().swap(lastRuns);
+    std::vector<int32_t>().swap(playCounts);
+    std::vector<FileStamp>().swap(indexStamps);
+    std::vector<uint32_t>().swap(probeStampIds);
+    probeStamps.assign(1, ProbeStamps());
+    std::vector<TableId>().swap(ids);
+    std::unordered_map<TableId, size_t>().swap(rowById);
+}
+
+TableEntry TableStore::get(size_t row) const {
+    TableEntry entry;
+    entry.filepath = filepath(row);
+    entry.filename = std::string(filename(row));
+    entry.name = std::string(name(row));
+    entry.year = std::string(year(row));
+    entry.author = std::string(author(row));
+    entry.version = std::string(version(row));
+    entry.gameName = std::string(gameName(row));
+    entry.requiresPinmame = requiresPinmame(row);
+    entry.lastRun = lastRun(row);
+    entry.playCount = playCounts[row];
+    entry.stamp = indexStamps[row];
+    getProbeResults(row, entry);
+    return entry;
+}
+
+void TableStore::getProbeResults(size_t row, TableEntry& entry) const {
+    entry.status = statuses[row];
+    entry.vbsModified = vbsModified(row);
+    entry.iniModified = iniModified(row);
+    const RowStamps s = stamps(row);
+    entry.scriptStamp = s.scriptStamp;
+    entry.scriptHash = s.scriptHash;
+    entry.vbsStamp = s.vbsStamp;
+    entry.vbsHash = s.vbsHash;
+    entry.iniStamp = s.iniStamp;
+    entry.iniBaseStamp = s.iniBaseStamp;
+    entry.iniOverrides.clear();
+    std::string_view joined = iniOverrides(row);
+    while (!joined.empty()) {
+        size_t next = joined.find('\n');
+        entry.iniOverrides.emplace_back(joined.substr(0, next));
+        joined = next == std::string_view::npos ? std::string_view() : joined.substr(next + 1);
+    }
+}
+
+bool TableStore::sameIndexData(size_t row, const TableEntry& entry) const {
+    return indexStamps[row] == entry.stamp && comparePath(row, entry.filepath) == 0 &&
+           filename(row) == entry.filename && name(row) == entry.name && year(row) == entry.year &&
+           author(row) == entry.author && version(row) == entry.version && gameName(row) == entry.gameName &&
+           requiresPinmame(row) == entry.requiresPinmame;
+}
+
+std::vector<TableEntry> TableStore::toEntries() const {
+    std::vector<TableEntry> entries;
+    entries.reserve(size());
+    for (size_t row = 0; row < size(); ++row) {
+        entries.push_back(get(row));
+    }
+    return entries;
+}
+
+int TableStore::comparePath(size_t row, std::string_view path) const {
+    std::string_view dir = pool.get(dirs[row]);
+    std::string_view head = path.substr(0, dir.size());
+    int result = dir.substr(0, head.size()).compare(head);
+    if (result != 0) return result;
+    if (path.size() < dir.size()) return 1; // path is a prefix of the directory alone
+    return span(tails[row]).compare(path.substr(dir.size()));
+}
+
+size_t TableStore::lowerBound(std::string_view path) const {
+    size_t low = 0, high = size();
+    while (low < high) {
+        size_t mid = low + (high - low) / 2;
+        if (comparePath(mid, path) < 0) low = mid + 1;
+        else high = mid;
+    }
+    return low;
+}
+
+size_t TableStore::find(std::string_view filepath) const {
+    size_t row = find(tableIdOf(filepath));
+    if (row == npos) return npos;
+    if (comparePath(row, filepath) == 0) return row;
+    // Another path hashed to the same ID first; fall back to the sorted order
+    row = lowerBound(filepath);
+    return row < size() && comparePath(row, filepath) == 0 ? row : npos;
+}
+
+size_t TableStore::find(TableId id) const {
+    auto it = rowById.find(id);
+    return it != rowById.end() ? it->second : npos;
+}
+
+std::string TableStore::filepath(size_t row) const {
+    std::string_view dir = pool.get(dirs[row]);
+    std::string_view tail = span(tails[row]);
+    std::string path;
+    path.reserve(dir.size() + tail.size());
+    path.append(dir.data(), dir.size());
+    path.append(tail.data(), tail.size());
+    return path;
+}
+
+std::string TableStore::folder(size_t row) const {
+    std::string path(pool.get(dirs[row]));
+    std::string_view tail = span(tails[row]);
+    size_t slash = tail.rfind('/');
+    if (slash != std::string_view::npos) {
+        path.append(tail.data(), slash);
+    } else if (path.size() > 1 && path.back() == '/') {
+        path.pop_back();
+    }
+    return path;
+}
+
+RowStamps TableStore::stamps(size_t row) const {
+    const ProbeStamps& probed = probeStamps[probeStampIds[row]];
+    RowStamps s;
+    s.stamp = indexStamps[row];
+    s.scriptStamp = probed.scriptStamp;
+    s.vbsStamp = probed.vbsStamp;
+    s.iniStamp = probed.iniStamp;
+    s.iniBaseStamp = probed.iniBaseStamp;
+    s.scriptHash = probed.scriptHash;
+    s.vbsHash = probed.vbsHash;
+    return s;
+}
+
+void TableStore::setProbeResults(size_t row, const TableEntry& probed) {
+    statuses[row] = probed.status;
+    flags[row] = static_cast<uint8_t>((flags[row] & FLAG_REQUIRES_PINMAME) |
+                                      (flagsOf(probed) & (FLAG_VBS_MODIFIED | FLAG_INI_MODIFIED)));
+    // The index stamp belongs to the parse, not the probe
+    setProbeStamps(row, probed);
+    overrides[row] = internOverrides(probed.iniOverrides);
+}
+
+void TableStore::setUserState(size_t row, const std::string& lastRun, int playCount) {
+    lastRuns[row] = lastRunCode(lastRun);
+    playCounts[row] = playCount;
+}
+
+size_t TableStore::memoryUsage() const {
+    return pool.memoryUsage() + arena.capacity() +
+           (dirs.capacity() + years.capacity() + authors.capacity() + versions.capacity() + gameNames.capacity() +
+            fuzzyKeys.capacity() + overrides.capacity() + statuses.capacity() + probeStampIds.capacity()) * sizeof(uint32_t) +
+           (tails.capacity() + filenames.capacity() + names.capacity() + searchKeys.capacity()) * sizeof(Span) +
+           flags.capacity() + lastRuns.capacity() + playCounts.capacity() * sizeof(int32_t) +
+           indexStamps.capacity() * sizeof(FileStamp) + probeStamps.capacity() * sizeof(ProbeStamps) +
+           ids.capacity() * sizeof(TableId) +
+           rowById.bucket_count() * sizeof(void*) + rowById.size() * (sizeof(TableId) + sizeof(size_t) + sizeof(void*));
+}
+
+uint8_t TableStore::lastRunCode(const std::string& lastRun) {
+    if (lastRun == "failed") return LAST_RUN_FAILED;
+    if (lastRun == "success") return LAST_RUN_SUCCESS;
+    return LAST_RUN_CLEAR;
+}
+
+uint8_t TableStore::flagsOf(const TableEntry& entry) {
+    return static_cast<uint8_t>((entry.vbsModified ? FLAG_VBS_MODIFIED : 0) |
+                                (entry.iniModified ? FLAG_INI_MODIFIED : 0) |
+                                (entry.requiresPinmame ? FLAG_REQUIRES_PINMAME : 0));
+}
+
+void TableStore::setProbeStamps(size_t row, const TableEntry& entry) {
+    const FileStamp none;
+    if (entry.scriptStamp == none && entry.vbsStamp == none && entry.iniStamp == none &&
+        entry.iniBaseStamp == none && entry.scriptHash == 0 && entry.vbsHash == 0) {
+        probeStampIds[row] = 0;
+        return;
+    }
+    if (probeStampIds[row] == 0) {
+        probeStampIds[row] = static_cast<uint32_t>(probeStamps.size());
+        probeStamps.emplace_back();
+    }
+    ProbeStamps& s = probeStamps[probeStampIds[row]];
+    s.scriptStamp = entry.scriptStamp;
+    s.vbsStamp = entry.vbsStamp;
+    s.iniStamp = entry.iniStamp;
+    s.iniBaseStamp = entry.iniBaseStamp;
+    s.scriptHash = entry.scriptHash;
+    s.vbsHash = entry.vbsHash;
+}
+
+uint32_t TableStore::internOverrides(const std::vector<std::string>& keys) {
+    if (keys.empty()) return 0;
+    std::string joined;
+    for (const auto& key : keys) {
+        if (!joined.empty()) joined += '\n';
+        joined += key;
+    }
+    return pool.intern(joined);
+}
+
+TableStore::Span TableStore::append(std::string_view text) {
+    Span s{static_cast<uint32_t>(arena.size()), static_cast<uint32_t>(text.size())};
+    arena.append(text.data(), text.size());
+    return s;
+}
\ No newline at end of file
@@ -0,0 +1,161 @@
+#ifndef TABLE_STORE_H
+#define TABLE_STORE_H
+
+#include "utils/structures.h"
+#include "tables/string_pool.h"
+#include <vector>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <cstdint>
+#include <cstddef>
+
+// Stamps and hashes TableUpdater uses to skip unchanged files, assembled from the store's cold
+// columns; never read by the launcher UI
+struct RowStamps {
+    FileStamp stamp;        // .vpx stat at index time
+    FileStamp scriptStamp;  // .vpx stat scriptHash was computed at
+    FileStamp vbsStamp;     // Sidecar .vbs stat vbsHash was computed at
+    FileStamp iniStamp;     // Table .ini stat the overrides were computed at
+    FileStamp iniBaseStamp; // VPinballX.ini stat the overrides were computed against
+    uint64_t scriptHash = 0;
+    uint64_t vbsHash = 0;
+};
+
+// Column store for the table library owned by TableManager. Every field is its own array, so
+// a sort, search or filter pass only touches the columns it reads:
+//   - years, authors, versions, ROM names, fuzzy keys, INI override lists and the directory
+//     holding each table folder (usually TablesDir) are interned in one StringPool as 4-byte ids
+//   - "<table folder>/<file>.vpx", table names and search keys live in one arena; a filepath is
+//     its interned directory plus that tail, and the file name and name point into it when equal
+//   - probe results are TableStatus bits plus a flag byte, lastRun is a one-byte code
+//   - script/INI stamps are only kept for rows that have a sidecar .vbs or .ini
+//   - each row's TableId, with a hash map from ID to row that also serves path lookups
+// Rows are kept sorted by filepath. TableEntry stays the record for parsing, probing and the
+// cache: get() and toEntries() materialize rows, assign() replaces them.
+class TableStore {
+public:
+    static constexpr size_t npos = static_cast<size_t>(-1);
+
+    TableStore() { clear(); }
+
+    // Replaces every row (compacting the pool and arena)
+    // rows: Entries sorted by filepath
+    void assign(const std::vector<TableEntry>& rows);
+
+    void clear();
+    size_t size() const { return dirs.size(); }
+    bool empty() const { return dirs.empty(); }
+
+    // Materializes one row, for code that probes, parses or saves whole entries
+    TableEntry get(size_t row) const;
+    std::vector<TableEntry> toEntries() const;
+
+    // First row whose filepath is not less than path
+    size_t lowerBound(std::string_view path) const;
+
+    // Row holding filepath, or npos; a hash lookup by tableIdOf(filepath)
+    size_t find(std::string_view filepath) const;
+
+    // Row of the table with this ID, or npos; stays valid across re-sorts of the filtered view,
+    // and across reloads for as long as the table keeps its path
+    size_t find(TableId id) const;
+
+    TableId id(size_t row) const { return ids[row]; }
+
+    // Compares the filepath of row with path like std::string::compare, without building it
+    int comparePath(size_t row, std::string_view path) const;
+
+    std::string filepath(size_t row) const;
+    std::string folder(size_t row) const; // Parent directory of filepath, no trailing '/'
+    std::string_view filename(size_t row) const { return span(filenames[row]); }
+    std::string_view name(size_t row) const { return span(names[row]); }
+    std::string_view year(size_t row) const { return pool.get(years[row]); }
+    std::string_view author(size_t row) const { return pool.get(authors[row]); }
+    std::string_view version(size_t row) const { return pool.get(versions[row]); }
+    std::string_view gameName(size_t row) const { return pool.get(gameNames[row]); }
+    std::string_view searchKey(size_t row) const { return span(searchKeys[row]); }
+    std::string_view fuzzyKey(size_t row) const { return pool.get(fuzzyKeys[row]); }
+    std::string_view iniOverrides(size_t row) const { return pool.get(overrides[row]); } // '\n'-separated
+    uint32_t status(size_t row) const { return statuses[row]; }
+    bool requiresPinmame(size_t row) const { return (flags[row] & FLAG_REQUIRES_PINMAME) != 0; }
+    bool vbsModified(size_t row) const { return (flags[row] & FLAG_VBS_MODIFIED) != 0; }
+    bool iniModified(size_t row) const { return (flags[row] & FLAG_INI_MODIFIED) != 0; }
+    bool failed(size_t row) const { return lastRuns[row] == LAST_RUN_FAILED; }
+    const char* lastRun(size_t row) const { return LAST_RUN_NAMES[lastRuns[row]]; }
+    int playCount(size_t row) const { return playCounts[row]; }
+    RowStamps stamps(size_t row) const;
+
+    // Copies what TableUpdater probed on a copy of row back: status bits, modified flags,
+    // script/INI stamps, hashes and INI overrides. New override lists and stamp records are
+    // appended, and only compacted by the next assign().
+    void setProbeResults(size_t row, const TableEntry& probed);
+
+    // lastRun: "clear", "success" or "failed"
+    void setUserState(size_t row, const std::string& lastRun, int playCount);
+
+    // Returns: true if entry holds what indexing produced for row: the same .vpx stamp and metadata
+    bool sameIndexData(size_t row, const TableEntry& entry) const;
+
+    // Copies the probe results of row into entry; the counterpart of setProbeResults()
+    void getProbeResults(size_t row, TableEntry& entry) const;
+
+    // Bytes held by the columns, the pool and the arena
+    size_t memoryUsage() const;
+
+private:
+    struct Span {
+        uint32_t offset;
+        uint32_t length;
+    };
+
+    // Everything in RowStamps but the index stamp; all zero until a .vbs or .ini was compared
+    struct ProbeStamps {
+        FileStamp scriptStamp;
+        FileStamp vbsStamp;
+        FileStamp iniStamp;
+        FileStamp iniBaseStamp;
+        uint64_t scriptHash = 0;
+        uint64_t vbsHash = 0;
+    };
+
+    enum : uint8_t { FLAG_VBS_MODIFIED = 1u << 0, FLAG_INI_MODIFIED = 1u << 1, FLAG_REQUIRES_PINMAME = 1u << 2 };
+    enum : uint8_t { LAST_RUN_CLEAR, LAST_RUN_SUCCESS, LAST_RUN_FAILED };
+    static const char* const LAST_RUN_NAMES[3];
+
+    static uint8_t lastRunCode(const std::string& lastRun);
+    static uint8_t flagsOf(const TableEntry& entry);
+    uint32_t internOverrides(const std::vector<std::string>& keys);
+
+    // Points row at a ProbeStamps record holding entry's stamps, reusing its own record if it has one
+    void setProbeStamps(size_t row, const TableEntry& entry);
+
+    std::string_view span(Span s) const { return std::string_view(arena.data() + s.offset, s.length); }
+    Span append(std::string_view text);
+
+    StringPool pool;
+    std::string arena;
+
+    std::vector<uint32_t> dirs;      // Pool id of the directory holding the table folder, with its trailing '/'
+    std::vector<Span> tails;         // Rest of the filepath: "<table folder>/<file>.vpx"
+    std::vector<Span> filenames;     // Stem; usually points into the tail
+    std::vector<Span> names;
+    std::vector<Span> searchKeys;    // SearchIndex::makeSearchKey()
+    std::vector<uint32_t> years;
+    std::vector<uint32_t> authors;
+    std::vector<uint32_t> versions;
+    std::vector<uint32_t> gameNames;
+    std::vector<uint32_t> fuzzyKeys; // SearchIndex::makeFuzzyKey()
+    std::vector<uint32_t> overrides; // Joined INI override keys
+    std::vector<uint32_t> statuses;  // TableStatus bits
+    std::vector<uint8_t> flags;
+    std::vector<uint8_t> lastRuns;
+    std::vector<int32_t> playCounts;
+    std::vector<FileStamp> indexStamps;   // .vpx stat at index time
+    std::vector<uint32_t> probeStampIds;  // Index into probeStamps; 0 is the all-zero record
+    std::vector<ProbeStamps> probeStamps;
+    std::vector<TableId> ids;             // tableIdOf(filepath)
+    std::unordered_map<TableId, size_t> rowById; // Rows whose ID collides with an earlier row are left out and found by path
+};
+
+#endif // TABLE_STORE_H
\ No newline at end of file
@@ -1,14 +1,18 @@
 #include "tables/table_updater.h"
+#include "tables/table_loader.h"
+#include "tables/vpx_reader.h"
 #include <filesystem>
+#include <fstream>
+#include <iterator>
 #include <iostream>
 #include <array>
-#include <fstream>
 #include <thread>
 #include <vector>
 #include <algorithm>
 #include <cctype>
 
-TableUpdater::TableUpdater(IConfigProvider& config, std::mutex& mutex) : config(config), tablesMutex(mutex) {}
+TableUpdater::TableUpdater(IConfigProvider& config, std::recursive_mutex& mutex, std::atomic<uint64_t>& dataVersion)
+    : config(config), tablesMutex(mutex), dataVersion(dataVersion) {}
 
 void TableUpdater::checkRomForChunk(std::vector<TableEntry>& tables, size_t start, size_t end) {
     // Retained for reference; not called in full-threaded version
@@ -20,13 +24,13 @@ void TableUpdater::checkRomForChunk(std::vector<TableEntry>& tables, size_t star
             LOG_DEBUG("Skipping ROM check for " << table.name << ": folder does not exist: " << folder);
             continue;
         }
-        table.rom = "";
+        table.status &= ~STATUS_ROM;
         if (table.requiresPinmame && !table.gameName.empty()) {
             std::string romPath = folder + "/" + config.getRomPath() + "/" + table.gameName + ".zip";
             LOG_DEBUG("Checking ROM for " << table.name << ": requiresPinmame=" << table.requiresPinmame 
                       << ", gameName=" << table.gameName << ", path=" << romPath);
             if (std::filesystem::exists(romPath)) {
-                table.rom = table.gameName;
+                table.status |= STATUS_ROM;
                 LOG_DEBUG("ROM found for " << table.name << ": " << table.gameName);
             } else {
                 LOG_DEBUG("ROM not found for " << table.name << " at " << romPath);
@@ -40,95 +44,75 @@ void TableUpdater::checkRomForChunk(std::vector<TableEntry>& tables, size_t star
     LOG_DEBUG("Finished ROM check for chunk [" << start << ", " << end << ") in thread " << std::this_thread::get_id());
 }
 
-void TableUpdater::updateChunk(std::vector<TableEntry>& tables, size_t start, size_t end) {
+void TableUpdater::updateChunk(std::vector<TableEntry>& tables, size_t start, size_t end, uint32_t probes) {
     LOG_DEBUG("Updating chunk [" << start << ", " << end << ") in thread " << std::this_thread::get_id());
+    std::shared_ptr<const FolderSnapshot> snapshot;
     for (size_t i = start; i < end && i < tables.size(); ++i) {
+        if (cancelRequested) break;
         auto& table = tables[i];
         std::string folder = std::filesystem::path(table.filepath).parent_path().string();
-        if (!std::filesystem::exists(folder)) {
+        // Rows are sorted by path, so tables sharing a folder reuse one listing
+        if (!snapshot || snapshot->getFolder() != folder) {
+            snapshot = takeSnapshot(folder);
+        }
+        if (!snapshot->isValid()) {
             LOG_DEBUG("Skipping update for " << table.name << ": folder does not exist: " << folder);
             continue; // Invalid indices handled outside chunk
         }
 
         std::string basename = table.filename;
         std::string iniFile = folder + "/" + basename + ".ini";
-        std::string vbsFile = folder + "/" + basename + ".vbs";
-        std::string b2sFileLower = folder + "/" + basename + ".directb2s";
-        std::string b2sFileUpper = folder + "/" + basename + ".directB2S";
-
-        bool vbsExists = std::filesystem::exists(vbsFile);
-        table.vbsModified = false;
-        if (vbsExists) {
-            std::string cmd = "\"" + config.getVpxTool() + "\" " + config.getDiffSubCmd() + " \"" + table.filepath + "\"";
-            std::array<char, 128> buffer;
-            std::string result;
-            FILE* pipe = popen(cmd.c_str(), "r");
-            if (pipe) {
-                while (fgets(buffer.data(), buffer.size(), pipe)) result += buffer.data();
-                pclose(pipe);
-                bool isWhitespace = std::all_of(result.begin(), result.end(), isspace);
-                table.vbsModified = (!result.empty() && !isWhitespace && 
-                                    (result.find("---") != std::string::npos || result.find("+++") != std::string::npos));
-            }
+
+        bool vbsExists = snapshot->exists(basename + ".vbs");
+        if (probes & PROBE_VBS) {
+            table.vbsModified = vbsExists && isScriptModified(table, folder + "/" + basename + ".vbs");
         }
 
-        bool iniExists = std::filesystem::exists(iniFile);
-        table.iniModified = false;
-        if (iniExists) {
-            std::string cmd = "diff \"" + config.getVPinballXIni() + "\" \"" + iniFile + "\"";
-            FILE* pipe = popen(cmd.c_str(), "r");
-            if (pipe) {
-                std::array<char, 128> buffer;
-                std::string result;
-                while (fgets(buffer.data(), buffer.size(), pipe)) result += buffer.data();
-                table.iniModified = (pclose(pipe) != 0);
+        bool iniExists = snapshot->exists(basename + ".ini");
+        if (probes & PROBE_INI) {
+            if (iniExists) {
+                compareIni(table, iniFile);
+            } else {
+                table.iniOverrides.clear();
+                table.iniStamp = FileStamp();
             }
+            table.iniModified = !table.iniOverrides.empty();
         }
 
-        bool b2sExists = std::filesystem::exists(b2sFileLower) || std::filesystem::exists(b2sFileUpper);
-        table.extraFiles = std::string(iniExists ? "INI " : "") +
-                           std::string(vbsExists ? "VBS " : "") +
-                           std::string(b2sExists ? "B2S" : "");
-
-        bool hasUltraDmdFolder = false;
-        try {
-            for (const auto& entry : std::filesystem::directory_iterator(folder)) {
-                if (entry.is_directory()) {
-                    std::string folderName = entry.path().filename().string();
-                    LOG_DEBUG("Checking folder in " << folder << ": " << folderName);
-                    if (folderName.length() >= 9 && folderName.substr(folderName.length() - 9) == ".UltraDMD") {
-                        hasUltraDmdFolder = true;
-                        LOG_DEBUG("Found UltraDMD folder for " << table.name << ": " << folderName);
-                        break;
-                    }
-                }
-            }
-        } catch (const std::filesystem::filesystem_error& e) {
-            LOG_DEBUG("Failed to iterate directory " << folder << ": " << e.what());
-            continue; // Invalid indices handled outside
+        if (probes & PROBE_SIDECARS) {
+            bool b2sExists = snapshot->exists(basename + ".directb2s") || snapshot->exists(basename + ".directB2S");
+            table.status = (table.status & ~STATUS_SIDECARS) |
+                           (iniExists ? STATUS_INI : 0u) |
+                           (vbsExists ? STATUS_VBS : 0u) |
+                           (b2sExists ? STATUS_B2S : 0u);
+        }
+
+        if (probes & PROBE_MEDIA) {
+            uint32_t media = 0;
+            if (snapshot->hasDirectoryWithSuffix(".UltraDMD")) media |= STATUS_ULTRADMD;
+            if (snapshot->exists(config.getAltSoundPath())) media |= STATUS_ALTSOUND;
+            if (snapshot->exists(config.getAltColorPath())) media |= STATUS_ALTCOLOR;
+            if (snapshot->exists(config.getPupPackPath())) media |= STATUS_PUPPACK;
+            if (snapshot->exists(config.getMusicPath())) media |= STATUS_MUSIC;
+            if (snapshot->exists(config.getWheelImage())) media |= STATUS_WHEEL_IMAGE;
+            if (snapshot->exists(config.getTableImage())) media |= STATUS_TABLE_IMAGE;
+            if (snapshot->exists(config.getBackglassImage())) media |= STATUS_BACKGLASS_IMAGE;
+            if (snapshot->exists(config.getMarqueeImage())) media |= STATUS_MARQUEE_IMAGE;
+            if (snapshot->exists(config.getTableVideo())) media |= STATUS_TABLE_VIDEO;
+            if (snapshot->exists(config.getBackglassVideo())) media |= STATUS_BACKGLASS_VIDEO;
+            if (snapshot->exists(config.getDmdVideo())) media |= STATUS_DMD_VIDEO;
+            table.status = (table.status & ~STATUS_MEDIA) | media;
         }
-        table.udmd = hasUltraDmdFolder ? u8"✪" : "";
-
-        table.alts = std::filesystem::exists(folder + config.getAltSoundPath()) ? u8"♪" : "";
-        table.altc = std::filesystem::exists(folder + config.getAltColorPath()) ? u8"☀" : "";
-        table.pup = std::filesystem::exists(folder + config.getPupPackPath()) ? u8"▣" : "";
-        table.music = std::filesystem::exists(folder + config.getMusicPath()) ? u8"♫" : "";
-        table.images = std::string(std::filesystem::exists(folder + config.getWheelImage()) ? "Wheel " : "") +
-                       std::string(std::filesystem::exists(folder + config.getTableImage()) ? "Table " : "") +
-                       std::string(std::filesystem::exists(folder + config.getBackglassImage()) ? "B2S " : "") +
-                       std::string(std::filesystem::exists(folder + config.getMarqueeImage()) ? "Marquee" : "");
-        table.videos = std::string(std::filesystem::exists(folder + config.getTableVideo()) ? "Table " : "") +
-                       std::string(std::filesystem::exists(folder + config.getBackglassVideo()) ? "B2S " : "") +
-                       std::string(std::filesystem::exists(folder + config.getDmdVideo()) ? "DMD" : "");
 
         // ROM check (moved from checkRomForChunk)
-        table.rom = "";
+        if (!(probes & PROBE_ROM)) continue;
+        table.status &= ~STATUS_ROM;
         if (table.requiresPinmame && !table.gameName.empty()) {
-            std::string romPath = folder + "/" + config.getRomPath() + "/" + table.gameName + ".zip";
+            std::string romPath = config.getRomPath() + "/" + table.gameName + ".zip";
             LOG_DEBUG("Checking ROM for " << table.name << ": requiresPinmame=" << table.requiresPinmame 
-                      << ", gameName=" << table.gameName << ", path=" << romPath);
-            if (std::filesystem::exists(romPath)) {
-                table.rom = table.gameName;
+                      << ", gameName=" << table.gameName << ", path=" << folder << "/" << romPath);
+            if (snapshot->exists(romPath)) {
+                table.status |= STATUS_ROM;
                 LOG_DEBUG("ROM found for " << table.name << ": " << table.gameName);
             } else {
                 LOG_DEBUG("ROM not found for " << table.name << " at " << romPath);
@@ -142,68 +126,130 @@ void TableUpdater::updateChunk(std::vector<TableEntry>& tables, size_t start, si
     LOG_DEBUG("Finished updating chunk [" << start << ", " << end << ")");
 }
 
-void TableUpdater::updateTablesAsync(std::vector<TableEntry>& tables, std::vector<TableEntry>& filteredTables, bool& loading) {
-    std::thread([this, &tables, &filteredTables, &loading]() {
-        loading = true;
-        std::lock_guard<std::mutex> lock(tablesMutex);
-
-        std::vector<std::pair<std::string, int>> preservedValues(tables.size());
-        for (size_t i = 0; i < tables.size(); ++i) {
-            preservedValues[i] = {tables[i].lastRun, tables[i].playCount};
+bool TableUpdater::isScriptModified(TableEntry& table, const std::string& vbsFile) {
+    // Each hash is reused for as long as the file it came from keeps its (size, mtime, inode)
+    FileStamp vpxStamp = TableLoader::statFile(table.filepath);
+    if (table.scriptStamp != vpxStamp) {
+        std::string script;
+        if (!VpxReader::readScript(table.filepath, script)) {
+            LOG_DEBUG("No readable script in " << table.filepath << ", falling back to vpxtool diff");
+            return diffWithVpxtool(table);
         }
+        table.scriptHash = VpxReader::hashScript(script.data(), script.size());
+        table.scriptStamp = vpxStamp;
+    }
+    FileStamp vbsStamp = TableLoader::statFile(vbsFile);
+    if (table.vbsStamp != vbsStamp) {
+        std::ifstream file(vbsFile, std::ios::binary);
+        if (!file.is_open()) {
+            LOG_DEBUG("Failed to read " << vbsFile);
+            return false;
+        }
+        std::string contents((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+        table.vbsHash = VpxReader::hashScript(contents.data(), contents.size());
+        table.vbsStamp = vbsStamp;
+    }
+    return table.scriptHash != table.vbsHash;
+}
 
-        const size_t numThreads = std::thread::hardware_concurrency();
-        const size_t chunkSize = tables.size() / numThreads + (tables.size() % numThreads != 0 ? 1 : 0);
-        std::vector<std::thread> threads;
+void TableUpdater::compareIni(TableEntry& table, const std::string& iniFile) {
+    // Reused while neither the table INI nor VPinballX.ini changed since the last comparison
+    FileStamp iniStamp = TableLoader::statFile(iniFile);
+    if (iniStamp == table.iniStamp && baseIniStamp == table.iniBaseStamp) return;
 
-        LOG_DEBUG("Updating " << tables.size() << " tables with " << numThreads << " threads, chunk size=" << chunkSize);
-        for (size_t i = 0; i < tables.size(); i += chunkSize) {
-            size_t start = i;
-            size_t end = std::min(i + chunkSize, tables.size());
-            threads.emplace_back(&TableUpdater::updateChunk, this, std::ref(tables), start, end);
-        }
+    IniSettings tableIni;
+    if (!tableIni.load(iniFile)) {
+        table.iniOverrides.clear();
+        return;
+    }
+    table.iniOverrides = tableIni.overridesOf(*baseIni);
+    table.iniStamp = iniStamp;
+    table.iniBaseStamp = baseIniStamp;
+    LOG_DEBUG(table.name << " overrides " << table.iniOverrides.size() << " setting(s)");
+}
 
-        for (auto& thread : threads) {
-            thread.join();
-        }
+bool TableUpdater::diffWithVpxtool(const TableEntry& table) {
+    std::string cmd = "\"" + config.getVpxTool() + "\" " + config.getDiffSubCmd() + " \"" + table.filepath + "\"";
+    std::array<char, 128> buffer;
+    std::string result;
+    FILE* pipe = popen(cmd.c_str(), "r");
+    if (!pipe) return false;
+    while (fgets(buffer.data(), buffer.size(), pipe)) result += buffer.data();
+    pclose(pipe);
+    bool isWhitespace = std::all_of(result.begin(), result.end(), isspace);
+    return !result.empty() && !isWhitespace &&
+           (result.find("---") != std::string::npos || result.find("+++") != std::string::npos);
+}
 
-        for (size_t i = 0; i < tables.size(); ++i) {
-            tables[i].lastRun = preservedValues[i].first;
-            tables[i].playCount = preservedValues[i].second;
-        }
+void TableUpdater::updateTables(TableStore& tables, const std::vector<size_t>& indices, uint32_t probes, TaskPriority priority) {
+    if (indices.empty()) {
+        LOG_DEBUG("No stale tables to update");
+        return;
+    }
+
+    if (probes & PROBE_INI) {
+        // Parsed once per update and shared read-only by all workers
+        auto settings = std::make_shared<IniSettings>();
+        settings->load(config.getVPinballXIni());
+        baseIni = settings;
+        baseIniStamp = TableLoader::statFile(config.getVPinballXIni());
+    }
 
-        json j;
-        j["last_updated"] = std::chrono::system_clock::now().time_since_epoch().count();
-        for (const auto& t : tables) {
-            json tj;
-            tj["filepath"] = t.filepath;
-            tj["filename"] = t.filename;
-            tj["year"] = t.year;
-            tj["author"] = t.author;
-            tj["name"] = t.name;
-            tj["version"] = t.version;
-            tj["extraFiles"] = t.extraFiles;
-            tj["rom"] = t.rom;
-            tj["udmd"] = t.udmd;
-            tj["alts"] = t.alts;
-            tj["altc"] = t.altc;
-            tj["pup"] = t.pup;
-            tj["music"] = t.music;
-            tj["images"] = t.images;
-            tj["videos"] = t.videos;
-            tj["vbsModified"] = t.vbsModified;
-            tj["iniModified"] = t.iniModified;
-            tj["requiresPinmame"] = t.requiresPinmame;
-            tj["gameName"] = t.gameName;
-            tj["lastRun"] = t.lastRun;
-            tj["playCount"] = t.playCount; // Save playCount
-            j["tables"].push_back(tj);
+    // Probe copies of the stale rows so the UI keeps drawing from tables while files are checked
+    std::vector<TableEntry> work;
+    std::vector<size_t> rows;
+    {
+        std::lock_guard<std::recursive_mutex> lock(tablesMutex);
+        work.reserve(indices.size());
+        for (size_t index : indices) {
+            if (index >= tables.size()) continue;
+            work.push_back(tables.get(index));
+            rows.push_back(index);
         }
-        std::ofstream file(config.getBasePath() + "resources/tables_index.json");
-        file << j.dump(2);
+    }
 
-        filteredTables = tables;
-        loading = false;
-        LOG_DEBUG("Finished updating tables, loading=false");
-    }).detach();
+    // One task per table folder: rows are sorted by path, so tables sharing a folder are
+    // adjacent and reuse one listing, and a slow folder only ever holds up its own task
+    std::vector<size_t> groupStarts;
+    std::string lastFolder;
+    for (size_t i = 0; i < work.size(); ++i) {
+        std::string folder = std::filesystem::path(work[i].filepath).parent_path().string();
+        if (i == 0 || folder != lastFolder) groupStarts.push_back(i);
+        lastFolder = std::move(folder);
+    }
+    groupStarts.push_back(work.size());
+
+    LOG_DEBUG("Updating " << work.size() << " of " << tables.size() << " tables in " << groupStarts.size() - 1 << " folder tasks");
+    ThreadPool::instance().parallelFor(groupStarts.size() - 1, [&](size_t g) {
+        updateChunk(work, groupStarts[g], groupStarts[g + 1], probes);
+        patchRows(tables, work, rows, groupStarts[g], groupStarts[g + 1]);
+    }, priority);
+    LOG_DEBUG("Finished updating tables");
+}
+
+std::vector<std::string> TableUpdater::getProbePaths(IConfigProvider& config) {
+    return {
+        config.getAltSoundPath(), config.getAltColorPath(), config.getPupPackPath(), config.getMusicPath(),
+        config.getWheelImage(), config.getTableImage(), config.getBackglassImage(), config.getMarqueeImage(),
+        config.getTableVideo(), config.getBackglassVideo(), config.getDmdVideo(),
+        config.getRomPath() + "/rom.zip", // Any file name: lists the ROM folder
+    };
+}
+
+std::shared_ptr<const FolderSnapshot> TableUpdater::takeSnapshot(const std::string& folder) {
+    return std::make_shared<const FolderSnapshot>(folder, getProbePaths(config));
+}
+
+void TableUpdater::cancel() {
+    cancelRequested = true;
+}
+
+void TableUpdater::patchRows(TableStore& tables, const std::vector<TableEntry>& work, const std::vector<size_t>& rows, size_t start, size_t end) {
+    std::lock_guard<std::recursive_mutex> lock(tablesMutex);
+    // Only probe results are copied; lastRun and playCount may have changed since the copy was taken
+    for (size_t n = start; n < end && n < work.size(); ++n) {
+        if (rows[n] >= tables.size() || tables.comparePath(rows[n], work[n].filepath) != 0) continue;
+        tables.setProbeResults(rows[n], work[n]);
+    }
+    ++dataVersion;
 }
\ No newline at end of file
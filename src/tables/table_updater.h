@@ -3,36 +3,89 @@
 
 #include "utils/logging.h"
 #include "utils/structures.h"
+#include "utils/thread_pool.h"
 #include "config/iconfig_provider.h"
-#include <json.hpp>
+#include "tables/table_store.h"
+#include "tables/folder_snapshot.h"
+#include "tables/ini_settings.h"
 #include <vector>
+#include <memory>
+#include <unordered_map>
 #include <mutex>
+#include <atomic>
+#include <cstdint>
 
-using json = nlohmann::json;
+// Groups of file checks a table update can be limited to
+enum ProbeFlags : uint32_t {
+    PROBE_SIDECARS = 1u << 0, // .ini/.vbs/.directb2s presence (STATUS_SIDECARS)
+    PROBE_VBS = 1u << 1,      // Script diff against the sidecar .vbs
+    PROBE_INI = 1u << 2,      // Table .ini against VPinballX.ini
+    PROBE_MEDIA = 1u << 3,    // UltraDMD, AltSound, AltColor, PuP, music, images, videos (STATUS_MEDIA)
+    PROBE_ROM = 1u << 4,      // ROM zip (STATUS_ROM)
+    PROBE_ALL = 0x1fu
+};
 
 class TableUpdater {
 public:
     // Constructor: Initializes with config provider and mutex for thread safety
-    TableUpdater(IConfigProvider& config, std::mutex& mutex);
+    // dataVersion: Counter bumped whenever probe results are patched into the shared rows
+    TableUpdater(IConfigProvider& config, std::recursive_mutex& mutex, std::atomic<uint64_t>& dataVersion);
+
+    // Re-probes sidecar files, media, ROMs and diffs for the given rows on the thread pool.
+    // Rows are probed on copies and patched back folder by folder under the mutex, so
+    // readers are only blocked for the copy, never for the file checks. The cache is not
+    // written here; the caller saves once its whole pass is done.
+    // tables: Shared table store, guarded by the mutex
+    // indices: Rows of tables to re-probe; returns immediately when empty
+    // probes: ProbeFlags selecting which checks to run; other fields keep their values
+    // priority: Thread pool lane for the probing tasks
+    void updateTables(TableStore& tables, const std::vector<size_t>& indices, uint32_t probes = PROBE_ALL,
+                      TaskPriority priority = TaskPriority::Background);
 
-    // Updates table metadata asynchronously in a detached thread
-    // tables: Vector of table entries to update
-    // filteredTables: Vector to store updated filtered entries
-    // loading: Flag to indicate update in progress
-    void updateTablesAsync(std::vector<TableEntry>& tables, std::vector<TableEntry>& filteredTables, bool& loading);
+    // Stops updateTables() after the rows currently being probed; used on shutdown
+    void cancel();
+
+    // Media, ROM and sidecar paths relative to a table folder that the probes check
+    static std::vector<std::string> getProbePaths(IConfigProvider& config);
 
 private:
-    // Updates a chunk of tables (file checks, ROMs, diffs) in a separate thread
-    // tables: Vector of table entries to update
-    // start: Starting index of the chunk
-    // end: Ending index of the chunk
-    void updateChunk(std::vector<TableEntry>& tables, size_t start, size_t end);
+    // Updates a range of tables (file checks, ROMs, diffs) within one pool task
+    // tables: Working copies of the rows being probed
+    // start: Starting index for this chunk
+    // end: Ending index for this chunk
+    // probes: ProbeFlags selecting which checks to run
+    void updateChunk(std::vector<TableEntry>& tables, size_t start, size_t end, uint32_t probes);
+
+    // Copies probe results for a finished range back into the shared rows
+    // rows: Index in tables of each work entry; skipped if that row no longer holds the same file
+    void patchRows(TableStore& tables, const std::vector<TableEntry>& work, const std::vector<size_t>& rows, size_t start, size_t end);
+
+    // Compares the script stored in the .vpx with its sidecar .vbs via normalized content hashes
+    // table: Row being probed; its cached hashes and stamps are refreshed when a file changed
+    // vbsFile: Path of the sidecar .vbs
+    // Returns: true if the scripts differ
+    bool isScriptModified(TableEntry& table, const std::string& vbsFile);
+
+    // Compares a table INI with VPinballX.ini key by key and records the overridden settings
+    // table: Row being probed; iniOverrides and the INI stamps are refreshed if either file changed
+    // iniFile: Path of the table .ini
+    void compareIni(TableEntry& table, const std::string& iniFile);
+
+    // Runs vpxtool diff, for tables whose script the native reader cannot extract
+    bool diffWithVpxtool(const TableEntry& table);
+
+    // Lists a table folder and the configured media/ROM subfolders
+    std::shared_ptr<const FolderSnapshot> takeSnapshot(const std::string& folder);
 
     // Checks ROM availability for a chunk of tables (kept for reference, not used in full threading)
     void checkRomForChunk(std::vector<TableEntry>& tables, size_t start, size_t end);
 
     IConfigProvider& config; // Reference to configuration provider
-    std::mutex& tablesMutex; // Mutex for thread-safe table access
+    std::recursive_mutex& tablesMutex; // Mutex for thread-safe table access
+    std::atomic<uint64_t>& dataVersion; // Owner's table version, see TableManager
+    std::atomic<bool> cancelRequested{false}; // Set by cancel() to end probing early
+    std::shared_ptr<const IniSettings> baseIni; // VPinballX.ini as of the current update
+    FileStamp baseIniStamp; // Stat of VPinballX.ini when baseIni was parsed
 };
 
 #endif // TABLE_UPDATER_H
\ No newline at end of file
@@ -0,0 +1,176 @@
+#include "tables/table_watcher.h"
+#include <algorithm>
+#include <chrono>
+#include <cerrno>
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+
+namespace {
+
+// Creation, completed writes, deletion and renames; IN_MODIFY is left out on purpose
+// because a large copy fires it for every block written. IN_CREATE only matters for
+// directories: a new file is reported by its IN_CLOSE_WRITE once the writer is done.
+const uint32_t WATCH_MASK = IN_CREATE | IN_CLOSE_WRITE | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO | IN_ONLYDIR;
+
+}
+
+TableWatcher::~TableWatcher() {
+    stop();
+}
+
+bool TableWatcher::start(const std::string& dir, Callback cb) {
+    stop();
+    inotifyFd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (inotifyFd < 0) {
+        std::cerr << "inotify unavailable, live table updates disabled: " << std::strerror(errno) << std::endl;
+        return false;
+    }
+    wakeFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (wakeFd < 0) {
+        close(inotifyFd);
+        inotifyFd = -1;
+        return false;
+    }
+    callback = std::move(cb);
+    watchTree(dir, false);
+    LOG_DEBUG("Watching " << watchPaths.size() << " folders below " << dir);
+    running = true;
+    thread = std::thread(&TableWatcher::run, this);
+    return true;
+}
+
+void TableWatcher::stop() {
+    if (running) {
+        running = false;
+        uint64_t one = 1;
+        if (write(wakeFd, &one, sizeof(one)) < 0) {
+            LOG_DEBUG("Failed to wake watcher thread: " << std::strerror(errno));
+        }
+    }
+    if (thread.joinable()) {
+        thread.join();
+    }
+    if (inotifyFd >= 0) close(inotifyFd);
+    if (wakeFd >= 0) close(wakeFd);
+    inotifyFd = -1;
+    wakeFd = -1;
+    watchPaths.clear();
+    pending.clear();
+    pendingOverflow = false;
+}
+
+void TableWatcher::addWatch(const std::string& dir) {
+    int wd = inotify_add_watch(inotifyFd, dir.c_str(), WATCH_MASK);
+    if (wd < 0) {
+        if (errno == ENOSPC) {
+            std::cerr << "inotify watch limit reached at " << dir
+                      << "; raise fs.inotify.max_user_watches for live updates of the whole library" << std::endl;
+        } else {
+            LOG_DEBUG("Failed to watch " << dir << ": " << std::strerror(errno));
+        }
+        return;
+    }
+    watchPaths[wd] = dir;
+}
+
+void TableWatcher::watchTree(const std::string& dir, bool reportContents) {
+    addWatch(dir);
+    std::error_code ec;
+    std::filesystem::recursive_directory_iterator it(dir, std::filesystem::directory_options::skip_permission_denied, ec);
+    for (; !ec && it != std::filesystem::recursive_directory_iterator(); it.increment(ec)) {
+        if (it->is_directory(ec)) {
+            addWatch(it->path().string());
+        } else if (reportContents) {
+            // Files copied in before the watch existed produced no events of their own
+            pending.push_back(it->path().string());
+        }
+    }
+    if (ec) {
+        LOG_DEBUG("Failed to walk " << dir << ": " << ec.message());
+    }
+}
+
+void TableWatcher::run() {
+    using Clock = std::chrono::steady_clock;
+    Clock::time_point firstEvent;
+    Clock::time_point lastEvent;
+    alignas(struct inotify_event) char buffer[16 * 1024];
+
+    while (running) {
+        int timeout = -1;
+        if (!pending.empty() || pendingOverflow) {
+            auto now = Clock::now();
+            auto quiet = std::chrono::duration_cast<std::chrono::milliseconds>(now - lastEvent).count();
+            auto age = std::chrono::duration_cast<std::chrono::milliseconds>(now - firstEvent).count();
+            timeout = static_cast<int>(std::max<long long>(0, std::min<long long>(DEBOUNCE_MS - quiet, MAX_DELAY_MS - age)));
+        }
+
+        pollfd fds[2] = {{inotifyFd, POLLIN, 0}, {wakeFd, POLLIN, 0}};
+        int ready = poll(fds, 2, timeout);
+        if (ready < 0 && errno != EINTR) {
+            std::cerr << "Table watcher stopped: " << std::strerror(errno) << std::endl;
+            // Events may have been lost: report an overflow so the owner revalidates, and let
+            // isRunning() tell it to start the watcher again
+            running = false;
+            TableChanges changes;
+            changes.overflow = true;
+            if (callback) callback(changes);
+            break;
+        }
+        if (!running || (ready > 0 && (fds[1].revents & POLLIN))) break;
+
+        if (ready > 0 && (fds[0].revents & POLLIN)) {
+            for (;;) {
+                ssize_t len = read(inotifyFd, buffer, sizeof(buffer));
+                if (len <= 0) break; // EAGAIN: queue drained
+                for (char* ptr = buffer; ptr < buffer + len;) {
+                    const auto* event = reinterpret_cast<const struct inotify_event*>(ptr);
+                    ptr += sizeof(struct inotify_event) + event->len;
+
+                    if (pending.empty() && !pendingOverflow) firstEvent = Clock::now();
+                    lastEvent = Clock::now();
+
+                    if (event->mask & IN_Q_OVERFLOW) {
+                        pendingOverflow = true;
+                        continue;
+                    }
+                    if (event->mask & IN_IGNORED) {
+                        watchPaths.erase(event->wd);
+                        continue;
+                    }
+                    auto dir = watchPaths.find(event->wd);
+                    if (dir == watchPaths.end() || event->len == 0) continue;
+
+                    // A .vpx still being copied would fail to parse; it is picked up when it is closed
+                    if ((event->mask & IN_CREATE) && !(event->mask & IN_ISDIR)) continue;
+                    std::string path = dir->second + "/" + event->name;
+                    if ((event->mask & IN_ISDIR) && (event->mask & (IN_CREATE | IN_MOVED_TO))) {
+                        watchTree(path, true);
+                    }
+                    pending.push_back(std::move(path));
+                }
+            }
+        }
+
+        if (pending.empty() && !pendingOverflow) continue;
+        auto now = Clock::now();
+        if (now - lastEvent < std::chrono::milliseconds(DEBOUNCE_MS) &&
+            now - firstEvent < std::chrono::milliseconds(MAX_DELAY_MS)) {
+            continue;
+        }
+
+        TableChanges changes;
+        std::sort(pending.begin(), pending.end());
+        pending.erase(std::unique(pending.begin(), pending.end()), pending.end());
+        changes.paths.swap(pending);
+        changes.overflow = pendingOverflow;
+        pendingOverflow = false;
+        LOG_DEBUG("Delivering " << changes.paths.size() << " changed path(s)" << (changes.overflow ? " after queue overflow" : ""));
+        if (callback) callback(changes);
+    }
+}
\ No newline at end of file
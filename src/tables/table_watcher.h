@@ -0,0 +1,62 @@
+#ifndef TABLE_WATCHER_H
+#define TABLE_WATCHER_H
+
+#include "utils/logging.h"
+#include <functional>
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <atomic>
+#include <thread>
+
+// Batch of filesystem changes collected between two quiet periods
+struct TableChanges {
+    std::vector<std::string> paths; // Created, modified, deleted or moved paths, deduplicated
+    bool overflow = false;          // Kernel queue overflowed; paths is incomplete and a full refresh is needed
+};
+
+// inotify watcher over the tables directory and every folder below it.
+// Events are debounced and coalesced on a background thread, so copying a whole
+// pupvideos folder in results in one batch once the copy goes quiet.
+class TableWatcher {
+public:
+    using Callback = std::function<void(const TableChanges&)>;
+
+    TableWatcher() = default;
+    ~TableWatcher();
+    TableWatcher(const TableWatcher&) = delete;
+    TableWatcher& operator=(const TableWatcher&) = delete;
+
+    // Watches dir recursively and starts the event thread
+    // dir: Tables directory to watch
+    // callback: Invoked on the event thread with each coalesced batch
+    // Returns: false if inotify is unavailable; the watcher then stays idle
+    bool start(const std::string& dir, Callback callback);
+
+    // Stops the event thread and closes all watches
+    void stop();
+
+    // Returns: false once stopped, including when the event thread quit on an error
+    bool isRunning() const { return running; }
+
+private:
+    // Adds a watch on dir and every directory below it
+    // reportContents: Also report existing files, for folders that appeared after the watch started
+    void watchTree(const std::string& dir, bool reportContents);
+    void addWatch(const std::string& dir);
+    void run();
+
+    static constexpr int DEBOUNCE_MS = 400;  // Quiet time before a batch is delivered
+    static constexpr int MAX_DELAY_MS = 3000; // Upper bound for a batch under constant activity
+
+    int inotifyFd = -1;
+    int wakeFd = -1; // eventfd used to interrupt poll() on stop
+    std::unordered_map<int, std::string> watchPaths; // Watch descriptor -> directory
+    std::vector<std::string> pending;                 // Paths of the batch being collected
+    bool pendingOverflow = false;
+    Callback callback;
+    std::atomic<bool> running{false};
+    std::thread thread;
+};
+
+#endif // TABLE_WATCHER_H
\ No newline at end of file
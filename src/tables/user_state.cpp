@@ -0,0 +1,27 @@
+#include "tables/user_state.h"
+
+UserStateSnapshot::UserStateSnapshot(const std::unordered_map<std::string, const TableEntry*>& previous) {
+    rowById.reserve(previous.size());
+    paths.reserve(previous.size());
+    states.reserve(previous.size());
+    for (const auto& [filepath, entry] : previous) {
+        if (!rowById.emplace(tableIdOf(filepath), states.size()).second) continue;
+        paths.push_back(filepath);
+        PlayState state;
+        state.lastRun = entry->lastRun;
+        state.playCount = entry->playCount;
+        states.push_back(std::move(state));
+    }
+}
+
+const PlayState* UserStateSnapshot::find(const std::string& filepath) const {
+    auto it = rowById.find(tableIdOf(filepath));
+    if (it == rowById.end() || paths[it->second] != filepath) return nullptr;
+    return &states[it->second];
+}
+
+void UserStateSnapshot::applyTo(TableEntry& entry) const {
+    const PlayState* state = find(entry.filepath);
+    entry.lastRun = state ? state->lastRun : "clear";
+    entry.playCount = state ? state->playCount : 0;
+}
\ No newline at end of file
@@ -0,0 +1,37 @@
+#ifndef USER_STATE_H
+#define USER_STATE_H
+
+#include "utils/structures.h"
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <cstddef>
+
+// What the user did with a table, as opposed to what the indexer found in it
+struct PlayState {
+    std::string lastRun = "clear"; // "clear", "success", or "failed"
+    int playCount = 0;
+};
+
+// Immutable user state of the rows known before a load, built once and then read concurrently
+// by every parser task without locking. Rows are joined by TableId through one hash map.
+class UserStateSnapshot {
+public:
+    // previous: Rows from the cache or the live table list, by path
+    explicit UserStateSnapshot(const std::unordered_map<std::string, const TableEntry*>& previous);
+
+    // Returns: State recorded for the table at filepath, nullptr for a table not seen before
+    const PlayState* find(const std::string& filepath) const;
+
+    // Copies the recorded state into a freshly parsed entry; unknown tables get the defaults
+    void applyTo(TableEntry& entry) const;
+
+    size_t size() const { return states.size(); }
+
+private:
+    std::unordered_map<TableId, size_t> rowById; // Index into paths and states
+    std::vector<std::string> paths; // Checked on lookup, so an ID collision can't hand over another table's state
+    std::vector<PlayState> states;
+};
+
+#endif // USER_STATE_H
\ No newline at end of file
@@ -0,0 +1,405 @@
+#include "tables/vpx_reader.h"
+#include "utils/logging.h"
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+
+const uint8_t CFB_SIGNATURE[8] = {0xD0, 0xCF, 0x11, 0xE0, 0xA1, 0xB1, 0x1A, 0xE1};
+const uint32_t MAX_REG_SECT = 0xFFFFFFFA;
+const uint32_t END_OF_CHAIN = 0xFFFFFFFE;
+const uint32_t NO_STREAM = 0xFFFFFFFF;
+const size_t HEADER_DIFAT_COUNT = 109;
+
+uint16_t readU16(const uint8_t* p) {
+    return static_cast<uint16_t>(p[0] | (p[1] << 8));
+}
+
+uint32_t readU32(const uint8_t* p) {
+    return static_cast<uint32_t>(p[0]) | (static_cast<uint32_t>(p[1]) << 8) |
+           (static_cast<uint32_t>(p[2]) << 16) | (static_cast<uint32_t>(p[3]) << 24);
+}
+
+void appendUtf8(std::string& out, uint32_t cp) {
+    if (cp < 0x80) {
+        out += static_cast<char>(cp);
+    } else if (cp < 0x800) {
+        out += static_cast<char>(0xC0 | (cp >> 6));
+        out += static_cast<char>(0x80 | (cp & 0x3F));
+    } else if (cp < 0x10000) {
+        out += static_cast<char>(0xE0 | (cp >> 12));
+        out += static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+        out += static_cast<char>(0x80 | (cp & 0x3F));
+    } else {
+        out += static_cast<char>(0xF0 | (cp >> 18));
+        out += static_cast<char>(0x80 | ((cp >> 12) & 0x3F));
+        out += static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+        out += static_cast<char>(0x80 | (cp & 0x3F));
+    }
+}
+
+// Decodes UTF-16LE (as used by CFB names and TableInfo streams) into UTF-8, stopping at NUL
+std::string utf16leToUtf8(const uint8_t* p, size_t bytes) {
+    std::string out;
+    out.reserve(bytes / 2);
+    for (size_t i = 0; i + 1 < bytes; i += 2) {
+        uint32_t unit = readU16(p + i);
+        if (unit == 0) break;
+        if (unit >= 0xD800 && unit <= 0xDBFF && i + 3 < bytes) {
+            uint32_t low = readU16(p + i + 2);
+            if (low >= 0xDC00 && low <= 0xDFFF) {
+                appendUtf8(out, 0x10000 + ((unit - 0xD800) << 10) + (low - 0xDC00));
+                i += 2;
+                continue;
+            }
+        }
+        appendUtf8(out, unit);
+    }
+    return out;
+}
+
+std::string toLower(std::string s) {
+    std::transform(s.begin(), s.end(), s.begin(), [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    return s;
+}
+
+std::string trim(const std::string& s) {
+    size_t begin = s.find_first_not_of(" \t\r\n");
+    if (begin == std::string::npos) return "";
+    size_t end = s.find_last_not_of(" \t\r\n");
+    return s.substr(begin, end - begin + 1);
+}
+
+// Scans the script line by line, ignoring comments, for the cGameName constant and
+// a LoadVPM call (which is what makes a table depend on a PinMAME ROM)
+void scanScript(const std::string& script, VpxMetadata& meta) {
+    size_t pos = 0;
+    while (pos < script.size()) {
+        size_t eol = script.find_first_of("\r\n", pos);
+        if (eol == std::string::npos) eol = script.size();
+        std::string line = script.substr(pos, eol - pos);
+        pos = eol + 1;
+
+        size_t comment = line.find('\'');
+        if (comment != std::string::npos) line.erase(comment);
+        std::string lower = toLower(line);
+
+        if (meta.gameName.empty()) {
+            size_t key = lower.find("cgamename");
+            if (key != std::string::npos) {
+                size_t eq = lower.find('=', key);
+                size_t open = lower.find('"', key);
+                if (eq != std::string::npos && open != std::string::npos && eq < open) {
+                    size_t close = line.find('"', open + 1);
+                    if (close != std::string::npos) meta.gameName = trim(line.substr(open + 1, close - open - 1));
+                }
+            }
+        }
+
+        if (!meta.requiresPinmame) {
+            size_t call = lower.find("loadvpm");
+            if (call != std::string::npos) {
+                std::string before = trim(lower.substr(0, call));
+                bool isDefinition = before.size() >= 3 && before.compare(before.size() - 3, 3, "sub") == 0;
+                if (!isDefinition) meta.requiresPinmame = true;
+            }
+        }
+    }
+}
+
+} // namespace
+
+VpxReader::~VpxReader() {
+    close();
+}
+
+bool VpxReader::open(const std::string& path) {
+    close();
+    int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        LOG_DEBUG("VpxReader: cannot open " << path);
+        return false;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size < 512) {
+        ::close(fd);
+        LOG_DEBUG("VpxReader: file too small or unreadable: " << path);
+        return false;
+    }
+    void* mapped = mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (mapped == MAP_FAILED) {
+        LOG_DEBUG("VpxReader: mmap failed for " << path);
+        return false;
+    }
+    data = static_cast<const uint8_t*>(mapped);
+    dataSize = static_cast<size_t>(st.st_size);
+
+    if (!parseHeader() || !loadFat() || !loadDirectory() || !loadMiniFat()) {
+        LOG_DEBUG("VpxReader: not a valid compound file: " << path);
+        close();
+        return false;
+    }
+    return true;
+}
+
+void VpxReader::close() {
+    if (data) {
+        munmap(const_cast<uint8_t*>(data), dataSize);
+    }
+    data = nullptr;
+    dataSize = 0;
+    fat.clear();
+    miniFat.clear();
+    miniStreamSectors.clear();
+    entries.clear();
+}
+
+bool VpxReader::parseHeader() {
+    if (std::memcmp(data, CFB_SIGNATURE, sizeof(CFB_SIGNATURE)) != 0) return false;
+    uint16_t sectorShift = readU16(data + 0x1E);
+    uint16_t miniSectorShift = readU16(data + 0x20);
+    if ((sectorShift != 9 && sectorShift != 12) || miniSectorShift != 6) return false;
+    sectorSize = 1u << sectorShift;
+    miniSectorSize = 1u << miniSectorShift;
+    numFatSectors = readU32(data + 0x2C);
+    firstDirSector = readU32(data + 0x30);
+    miniStreamCutoff = readU32(data + 0x38);
+    firstMiniFatSector = readU32(data + 0x3C);
+    numMiniFatSectors = readU32(data + 0x40);
+    firstDifatSector = readU32(data + 0x44);
+    numDifatSectors = readU32(data + 0x48);
+    return true;
+}
+
+const uint8_t* VpxReader::sectorData(uint32_t sector) const {
+    if (sector > MAX_REG_SECT) return nullptr;
+    uint64_t offset = (static_cast<uint64_t>(sector) + 1) * sectorSize;
+    if (offset + sectorSize > dataSize) return nullptr;
+    return data + offset;
+}
+
+bool VpxReader::loadFat() {
+    std::vector<uint32_t> fatSectors;
+    fatSectors.reserve(numFatSectors);
+    for (size_t i = 0; i < HEADER_DIFAT_COUNT && fatSectors.size() < numFatSectors; ++i) {
+        fatSectors.push_back(readU32(data + 0x4C + i * 4));
+    }
+
+    // Remaining FAT sector ids live in the DIFAT chain; the last slot of each DIFAT sector links to the next
+    const uint32_t perDifat = sectorSize / 4 - 1;
+    uint32_t difat = firstDifatSector;
+    for (uint32_t n = 0; n < numDifatSectors && fatSectors.size() < numFatSectors; ++n) {
+        const uint8_t* p = sectorData(difat);
+        if (!p) return false;
+        for (uint32_t i = 0; i < perDifat && fatSectors.size() < numFatSectors; ++i) {
+            fatSectors.push_back(readU32(p + i * 4));
+        }
+        difat = readU32(p + perDifat * 4);
+    }
+    if (fatSectors.size() != numFatSectors) return false;
+
+    const uint32_t perSector = sectorSize / 4;
+    fat.resize(static_cast<size_t>(numFatSectors) * perSector);
+    for (size_t s = 0; s < fatSectors.size(); ++s) {
+        const uint8_t* p = sectorData(fatSectors[s]);
+        if (!p) return false;
+        for (uint32_t i = 0; i < perSector; ++i) {
+            fat[s * perSector + i] = readU32(p + i * 4);
+        }
+    }
+    return true;
+}
+
+bool VpxReader::loadDirectory() {
+    std::string dir;
+    if (!readChain(firstDirSector, 0, false, dir)) return false;
+    const size_t count = dir.size() / 128;
+    entries.resize(count);
+    for (size_t i = 0; i < count; ++i) {
+        const uint8_t* p = reinterpret_cast<const uint8_t*>(dir.data()) + i * 128;
+        DirEntry& e = entries[i];
+        uint16_t nameBytes = std::min<uint16_t>(readU16(p + 64), 64);
+        e.name = toLower(utf16leToUtf8(p, nameBytes));
+        e.type = p[66];
+        e.left = readU32(p + 68);
+        e.right = readU32(p + 72);
+        e.child = readU32(p + 76);
+        e.start = readU32(p + 116);
+        e.size = readU32(p + 120);
+        if (sectorSize == 4096) e.size |= static_cast<uint64_t>(readU32(p + 124)) << 32;
+    }
+    return !entries.empty() && entries[0].type == 5;
+}
+
+bool VpxReader::loadMiniFat() {
+    std::string bytes;
+    if (numMiniFatSectors > 0 && firstMiniFatSector <= MAX_REG_SECT) {
+        if (!readChain(firstMiniFatSector, 0, false, bytes)) return false;
+        miniFat.resize(bytes.size() / 4);
+        for (size_t i = 0; i < miniFat.size(); ++i) {
+            miniFat[i] = readU32(reinterpret_cast<const uint8_t*>(bytes.data()) + i * 4);
+        }
+    }
+
+    // The mini stream is the root entry's regular stream; remember its sectors so mini
+    // sectors can be resolved to file offsets without copying the whole mini stream
+    uint32_t sector = entries[0].start;
+    const size_t limit = fat.size();
+    while (sector <= MAX_REG_SECT && miniStreamSectors.size() <= limit) {
+        if (sector >= fat.size()) return false;
+        miniStreamSectors.push_back(sector);
+        sector = fat[sector];
+    }
+    return true;
+}
+
+bool VpxReader::readChain(uint32_t start, uint64_t size, bool mini, std::string& out) const {
+    out.clear();
+    const std::vector<uint32_t>& table = mini ? miniFat : fat;
+    const uint32_t unit = mini ? miniSectorSize : sectorSize;
+    const bool bounded = size > 0;
+    if (bounded) out.reserve(static_cast<size_t>(size));
+
+    uint32_t sector = start;
+    size_t steps = 0;
+    while (sector != END_OF_CHAIN) {
+        if (sector > MAX_REG_SECT || sector >= table.size() || ++steps > table.size()) return false;
+        const uint8_t* p = nullptr;
+        if (mini) {
+            uint64_t offset = static_cast<uint64_t>(sector) * miniSectorSize;
+            size_t index = static_cast<size_t>(offset / sectorSize);
+            if (index >= miniStreamSectors.size()) return false;
+            const uint8_t* base = sectorData(miniStreamSectors[index]);
+            if (!base) return false;
+            p = base + (offset % sectorSize);
+        } else {
+            p = sectorData(sector);
+            if (!p) return false;
+        }
+        size_t take = unit;
+        if (bounded) take = static_cast<size_t>(std::min<uint64_t>(unit, size - out.size()));
+        out.append(reinterpret_cast<const char*>(p), take);
+        if (bounded && out.size() >= size) break;
+        sector = table[sector];
+    }
+    return !bounded || out.size() == size;
+}
+
+int VpxReader::findChild(uint32_t storage, const std::string& name) const {
+    if (storage >= entries.size()) return -1;
+    // Siblings form a red-black tree; a plain walk is enough for the handful of entries per storage
+    std::vector<uint32_t> stack{entries[storage].child};
+    size_t visited = 0;
+    while (!stack.empty() && visited <= entries.size()) {
+        uint32_t id = stack.back();
+        stack.pop_back();
+        if (id == NO_STREAM || id >= entries.size()) continue;
+        ++visited;
+        if (entries[id].name == name) return static_cast<int>(id);
+        stack.push_back(entries[id].left);
+        stack.push_back(entries[id].right);
+    }
+    return -1;
+}
+
+bool VpxReader::readStream(const std::string& streamPath, std::string& out) const {
+    out.clear();
+    if (!data) return false;
+    uint32_t current = 0;
+    size_t pos = 0;
+    const std::string lowerPath = toLower(streamPath);
+    while (pos <= lowerPath.size()) {
+        size_t slash = lowerPath.find('/', pos);
+        if (slash == std::string::npos) slash = lowerPath.size();
+        int id = findChild(current, lowerPath.substr(pos, slash - pos));
+        if (id < 0) return false;
+        current = static_cast<uint32_t>(id);
+        pos = slash + 1;
+    }
+    const DirEntry& e = entries[current];
+    if (e.type != 2) return false;
+    if (e.size == 0) return true;
+    return readChain(e.start, e.size, e.size < miniStreamCutoff, out);
+}
+
+bool VpxReader::readScript(std::string& script) const {
+    script.clear();
+    std::string gameData;
+    if (!readStream("GameStg/GameData", gameData)) return false;
+
+    // GameData is a BIFF record list: [u32 length][4-byte tag][payload], where length covers the tag.
+    // CODE is special: its length only covers the tag and the script follows as a u32-prefixed blob.
+    const uint8_t* p = reinterpret_cast<const uint8_t*>(gameData.data());
+    const size_t size = gameData.size();
+    size_t pos = 0;
+    while (pos + 8 <= size) {
+        uint32_t length = readU32(p + pos);
+        const char* tag = reinterpret_cast<const char*>(p + pos + 4);
+        pos += 8;
+        if (std::memcmp(tag, "CODE", 4) == 0) {
+            if (pos + 4 > size) return false;
+            uint32_t codeLength = readU32(p + pos);
+            pos += 4;
+            if (codeLength > size - pos) return false;
+            script.assign(reinterpret_cast<const char*>(p + pos), codeLength);
+            return true;
+        }
+        if (std::memcmp(tag, "ENDB", 4) == 0 || length < 4) break;
+        pos += length - 4;
+    }
+    return false;
+}
+
+bool VpxReader::readMetadata(VpxMetadata& meta) const {
+    if (!data || findChild(0, "gamestg") < 0) return false;
+
+    auto readInfo = [this](const char* stream) {
+        std::string raw;
+        if (!readStream(std::string("TableInfo/") + stream, raw)) return std::string();
+        return trim(utf16leToUtf8(reinterpret_cast<const uint8_t*>(raw.data()), raw.size()));
+    };
+    meta.tableName = readInfo("TableName");
+    meta.authorName = readInfo("AuthorName");
+    meta.releaseDate = readInfo("ReleaseDate");
+    meta.tableVersion = readInfo("TableVersion");
+
+    meta.requiresPinmame = false;
+    meta.gameName.clear();
+    std::string script;
+    if (readScript(script)) {
+        scanScript(script, meta);
+    } else {
+        LOG_DEBUG("VpxReader: no script found in GameData");
+    }
+    return true;
+}
+
+bool VpxReader::readMetadata(const std::string& path, VpxMetadata& meta) {
+    VpxReader reader;
+    return reader.open(path) && reader.readMetadata(meta);
+}
+
+bool VpxReader::readScript(const std::string& path, std::string& script) {
+    VpxReader reader;
+    return reader.open(path) && reader.readScript(script);
+}
+
+uint64_t VpxReader::hashScript(const char* text, size_t size) {
+    // FNV-1a over the text with CRLF and lone CR folded to LF
+    uint64_t hash = 1469598103934665603ULL;
+    for (size_t i = 0; i < size; ++i) {
+        unsigned char c = static_cast<unsigned char>(text[i]);
+        if (c == '\r') {
+            if (i + 1 < size && text[i + 1] == '\n') continue;
+            c = '\n';
+        }
+        hash = (hash ^ c) * 1099511628211ULL;
+    }
+    return hash;
+}
\ No newline at end of file
@@ -0,0 +1,100 @@
+#ifndef VPX_READER_H
+#define VPX_READER_H
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+// Table metadata extracted from a .vpx file, mirroring the fields vpxtool writes to its index
+struct VpxMetadata {
+    std::string tableName;    // TableInfo/TableName
+    std::string authorName;   // TableInfo/AuthorName
+    std::string releaseDate;  // TableInfo/ReleaseDate
+    std::string tableVersion; // TableInfo/TableVersion
+    bool requiresPinmame = false; // Script loads the VPinMAME controller
+    std::string gameName;         // ROM game name from cGameName in the script
+};
+
+// Minimal read-only parser for the OLE/CFB compound file container used by .vpx tables.
+// The file is memory-mapped and streams are located through the FAT/MiniFAT chains,
+// so only the pages backing the requested streams are ever touched.
+class VpxReader {
+public:
+    VpxReader() = default;
+    ~VpxReader();
+    VpxReader(const VpxReader&) = delete;
+    VpxReader& operator=(const VpxReader&) = delete;
+
+    // Maps the file and parses the CFB header, FAT and directory
+    // path: Path to the .vpx file
+    // Returns: true if the file is a valid compound file
+    bool open(const std::string& path);
+
+    // Unmaps the file and clears all parsed state
+    void close();
+
+    // Reads a stream by its storage path, e.g. "TableInfo/TableName" (case-insensitive)
+    // streamPath: Slash-separated path below the root storage
+    // out: Receives the raw stream bytes
+    // Returns: true if the stream exists and its sector chain is intact
+    bool readStream(const std::string& streamPath, std::string& out) const;
+
+    // Reads TableInfo strings and script-derived ROM info into meta
+    // Returns: false if the file is not open or holds no GameStg storage
+    bool readMetadata(VpxMetadata& meta) const;
+
+    // Extracts the table script from the CODE record of GameStg/GameData
+    // script: Receives the script bytes as stored in the table
+    // Returns: true if a CODE record was found
+    bool readScript(std::string& script) const;
+
+    // Convenience wrapper: opens path, reads metadata and closes it again
+    static bool readMetadata(const std::string& path, VpxMetadata& meta);
+
+    // Convenience wrapper: opens path, reads the script and closes it again
+    static bool readScript(const std::string& path, std::string& script);
+
+    // Hashes script text with CRLF and CR line endings normalized to LF, matching how vpxtool
+    // compares the embedded script against an extracted .vbs
+    // text: Script bytes, from the table or a sidecar file
+    // size: Number of bytes in text
+    static uint64_t hashScript(const char* text, size_t size);
+
+private:
+    struct DirEntry {
+        std::string name;     // Entry name, lowercased ASCII/UTF-8
+        uint8_t type = 0;     // 1 = storage, 2 = stream, 5 = root
+        uint32_t left = 0;
+        uint32_t right = 0;
+        uint32_t child = 0;
+        uint32_t start = 0;   // First sector (or mini sector) of the stream
+        uint64_t size = 0;    // Stream size in bytes
+    };
+
+    bool parseHeader();
+    bool loadFat();
+    bool loadDirectory();
+    bool loadMiniFat();
+    bool readChain(uint32_t start, uint64_t size, bool mini, std::string& out) const;
+    const uint8_t* sectorData(uint32_t sector) const;
+    int findChild(uint32_t storage, const std::string& name) const;
+
+    const uint8_t* data = nullptr; // Mapped file contents
+    size_t dataSize = 0;
+    uint32_t sectorSize = 512;
+    uint32_t miniSectorSize = 64;
+    uint32_t miniStreamCutoff = 4096;
+    uint32_t firstDirSector = 0;
+    uint32_t firstMiniFatSector = 0;
+    uint32_t numMiniFatSectors = 0;
+    uint32_t firstDifatSector = 0;
+    uint32_t numDifatSectors = 0;
+    uint32_t numFatSectors = 0;
+    std::vector<uint32_t> fat;              // Sector allocation table
+    std::vector<uint32_t> miniFat;          // Mini sector allocation table
+    std::vector<uint32_t> miniStreamSectors; // Regular sectors holding the mini stream, in order
+    std::vector<DirEntry> entries;          // Flattened directory
+};
+
+#endif // VPX_READER_H
\ No newline at end of file
@@ -15,7 +15,12 @@ public:
         tooltips["Open Folder"] = "Open the folder of the selected table.\nIf no table selected, opens the tables root directory.";
         tooltips["Refresh"] = "Refresh table list.\nShift + Click for a full refresh (re-indexes all tables).";
         tooltips["▶ Play"] = "Launch the selected table with VPinballX.";
+        tooltips["Search"] = "Search names and filenames. Filters can be combined with text:\n"
+                             "author:jp  rom:afm  year:1980..1989  played:>5  failed\n"
+                             "has:rom  missing:wheel  modified:ini (ini vbs b2s rom udmd altsound altcolor\n"
+                             "pup music wheel table backglass marquee tablevideo b2svideo dmdvideo)";
         tooltips["X"] = "Clear the search query.";
+        tooltips["Fuzzy"] = "Fuzzy search: match letters in order, word initials (\"tz\"),\nauthors and ROM names, best matches first.";
         tooltips["✖ Quit"] = "Exit the application.";
     }
 
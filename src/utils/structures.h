@@ -2,28 +2,81 @@
 #define STRUCTURES_H
 
 #include <string>
+#include <string_view>
 #include <vector>
 #include <map>
+#include <cstdint>
+#include <cstddef>
 
 struct ConfigSection {
     std::vector<std::pair<std::string, std::string>> keyValues;
     std::map<std::string, size_t> keyToLineIndex;
 };
 
+// Identity of a .vpx on disk, used to detect added or modified tables without re-parsing
+struct FileStamp {
+    uint64_t size = 0;
+    int64_t mtime = 0; // Nanoseconds since epoch
+    uint64_t inode = 0;
+    bool operator==(const FileStamp& other) const {
+        return size == other.size && mtime == other.mtime && inode == other.inode;
+    }
+    bool operator!=(const FileStamp& other) const { return !(*this == other); }
+};
+
+// Presence of the files TableUpdater probes for a table, one bit each in TableEntry::status
+enum TableStatus : uint32_t {
+    STATUS_INI = 1u << 0,             // Table .ini
+    STATUS_VBS = 1u << 1,             // Sidecar .vbs
+    STATUS_B2S = 1u << 2,             // .directb2s backglass
+    STATUS_ROM = 1u << 3,             // ROM zip named after gameName
+    STATUS_ULTRADMD = 1u << 4,        // *.UltraDMD folder
+    STATUS_ALTSOUND = 1u << 5,
+    STATUS_ALTCOLOR = 1u << 6,
+    STATUS_PUPPACK = 1u << 7,
+    STATUS_MUSIC = 1u << 8,
+    STATUS_WHEEL_IMAGE = 1u << 9,
+    STATUS_TABLE_IMAGE = 1u << 10,
+    STATUS_BACKGLASS_IMAGE = 1u << 11,
+    STATUS_MARQUEE_IMAGE = 1u << 12,
+    STATUS_TABLE_VIDEO = 1u << 13,
+    STATUS_BACKGLASS_VIDEO = 1u << 14,
+    STATUS_DMD_VIDEO = 1u << 15,
+    // Bits written by each probe group of TableUpdater
+    STATUS_SIDECARS = STATUS_INI | STATUS_VBS | STATUS_B2S,
+    STATUS_IMAGES = STATUS_WHEEL_IMAGE | STATUS_TABLE_IMAGE | STATUS_BACKGLASS_IMAGE | STATUS_MARQUEE_IMAGE,
+    STATUS_VIDEOS = STATUS_TABLE_VIDEO | STATUS_BACKGLASS_VIDEO | STATUS_DMD_VIDEO,
+    STATUS_MEDIA = STATUS_ULTRADMD | STATUS_ALTSOUND | STATUS_ALTCOLOR | STATUS_PUPPACK | STATUS_MUSIC |
+                   STATUS_IMAGES | STATUS_VIDEOS,
+};
+
+// Short names of the TableStatus bits, by bit position; used by search filters and the JSON export
+inline const char* const TABLE_STATUS_NAMES[] = {
+    "ini", "vbs", "b2s", "rom", "udmd", "altsound", "altcolor", "pup", "music",
+    "wheel", "table", "backglass", "marquee", "tablevideo", "b2svideo", "dmdvideo",
+};
+const size_t TABLE_STATUS_COUNT = sizeof(TABLE_STATUS_NAMES) / sizeof(TABLE_STATUS_NAMES[0]);
+
+// Stable identity of a table across reloads, re-sorts and cache rewrites: a 64-bit FNV-1a hash
+// of its path, so it can be recomputed from any copy of the row without a lookup
+using TableId = uint64_t;
+const TableId NO_TABLE_ID = 0; // Never returned by tableIdOf(); "no table selected"
+
+inline TableId tableIdOf(std::string_view filepath) {
+    uint64_t hash = 14695981039346656037ull;
+    for (char c : filepath) {
+        hash ^= static_cast<unsigned char>(c);
+        hash *= 1099511628211ull;
+    }
+    return hash != NO_TABLE_ID ? hash : 1;
+}
+
 struct TableEntry {
     std::string year;
     std::string author;
     std::string name;
     std::string version;    // Table version from vpxtool
-    std::string extraFiles; // INI, VBS, B2S status
-    std::string rom;        // ROM status and name
-    std::string udmd;       // UltraDMD status
-    std::string alts;       // AltSound status
-    std::string altc;       // AltColor status
-    std::string pup;        // PUPPack status
-    std::string music;      // Music status
-    std::string images;     // Image status
-    std::string videos;     // Video status
+    uint32_t status = 0;    // TableStatus bits from the last probe
     std::string filename;   // Full basename
     std::string filepath;   // Full file path
     bool vbsModified = false; // VBS differs from internal
@@ -32,6 +85,14 @@ struct TableEntry {
     std::string gameName;         // ROM game name (e.g., "sprk_103")
     std::string lastRun = "clear"; // "clear", "success", or "failed"
     int playCount = 0; // adds up only on success runs
+    FileStamp stamp;   // .vpx stat at index time
+    FileStamp scriptStamp; // .vpx stat scriptHash was computed at
+    uint64_t scriptHash = 0; // Hash of the table script, line endings normalized
+    FileStamp vbsStamp;    // Sidecar .vbs stat vbsHash was computed at
+    uint64_t vbsHash = 0;  // Hash of the sidecar .vbs, line endings normalized
+    FileStamp iniStamp;     // Table .ini stat iniOverrides was computed at
+    FileStamp iniBaseStamp; // VPinballX.ini stat iniOverrides was computed against
+    std::vector<std::string> iniOverrides; // "Section/Key" settings the table .ini changes
 };
 
 #endif // STRUCTURES_H
\ No newline at end of file
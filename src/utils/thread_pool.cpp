@@ -0,0 +1,131 @@
+#include "utils/thread_pool.h"
+#include "utils/logging.h"
+#include <algorithm>
+
+namespace {
+
+// Index of the pool worker running on this thread, if any
+thread_local const ThreadPool* currentPool = nullptr;
+thread_local size_t currentWorker = 0;
+
+} // namespace
+
+ThreadPool& ThreadPool::instance() {
+    static ThreadPool pool(std::max<size_t>(2, std::thread::hardware_concurrency()));
+    return pool;
+}
+
+ThreadPool::ThreadPool(size_t threadCount) {
+    threadCount = std::max<size_t>(1, threadCount);
+    for (size_t i = 0; i < threadCount; ++i) {
+        queues.push_back(std::make_unique<Queue>());
+    }
+    for (size_t i = 0; i < threadCount; ++i) {
+        workers.emplace_back(&ThreadPool::workerLoop, this, i);
+    }
+    LOG_DEBUG("Started thread pool with " << threadCount << " workers");
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex);
+        stopping = true;
+    }
+    wake.notify_all();
+    for (auto& worker : workers) {
+        worker.join();
+    }
+}
+
+void ThreadPool::submit(Task task, TaskPriority priority) {
+    size_t target = currentPool == this ? currentWorker : nextQueue++ % queues.size();
+    {
+        std::lock_guard<std::mutex> lock(queues[target]->mutex);
+        queues[target]->lanes[static_cast<int>(priority)].push_back(std::move(task));
+        ++pending;
+    }
+    // Taking the lock orders this wake-up after a worker's check of pending
+    { std::lock_guard<std::mutex> lock(sleepMutex); }
+    wake.notify_one();
+}
+
+void ThreadPool::parallelFor(size_t count, const std::function<void(size_t)>& fn, TaskPriority priority) {
+    if (count == 0) return;
+
+    // Shared so a helper that only starts after the caller has returned finds no index left
+    // and exits without touching fn
+    struct Batch {
+        size_t count;
+        std::atomic<size_t> next{0};
+        std::atomic<size_t> remaining;
+        std::mutex mutex;
+        std::condition_variable done;
+    };
+    auto batch = std::make_shared<Batch>();
+    batch->count = count;
+    batch->remaining = count;
+    const std::function<void(size_t)>* body = &fn;
+    auto claimAll = [batch, body]() {
+        for (size_t i = batch->next++; i < batch->count; i = batch->next++) {
+            (*body)(i);
+            if (--batch->remaining == 0) {
+                std::lock_guard<std::mutex> lock(batch->mutex);
+                batch->done.notify_all();
+            }
+        }
+    };
+
+    const size_t helpers = std::min(count - 1, workers.size());
+    for (size_t i = 0; i < helpers; ++i) {
+        submit(claimAll, priority);
+    }
+    claimAll();
+
+    std::unique_lock<std::mutex> lock(batch->mutex);
+    batch->done.wait(lock, [&]() { return batch->remaining == 0; });
+}
+
+bool ThreadPool::tryPop(size_t self, Task& task) {
+    const size_t count = queues.size();
+    for (int lane = 0; lane < 2; ++lane) {
+        if (self < count) {
+            Queue& own = *queues[self];
+            std::lock_guard<std::mutex> lock(own.mutex);
+            if (!own.lanes[lane].empty()) {
+                task = std::move(own.lanes[lane].back());
+                own.lanes[lane].pop_back();
+                --pending;
+                return true;
+            }
+        }
+        const size_t start = self < count ? self + 1 : 0;
+        for (size_t k = 0; k < count; ++k) {
+            size_t victim = (start + k) % count;
+            if (victim == self) continue;
+            Queue& other = *queues[victim];
+            std::lock_guard<std::mutex> lock(other.mutex);
+            if (!other.lanes[lane].empty()) {
+                task = std::move(other.lanes[lane].front());
+                other.lanes[lane].pop_front();
+                --pending;
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+void ThreadPool::workerLoop(size_t index) {
+    currentPool = this;
+    currentWorker = index;
+    while (true) {
+        Task task;
+        if (tryPop(index, task)) {
+            task();
+            continue;
+        }
+        std::unique_lock<std::mutex> lock(sleepMutex);
+        wake.wait(lock, [this]() { return stopping || pending > 0; });
+        if (stopping) break;
+    }
+}
\ No newline at end of file
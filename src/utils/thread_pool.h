@@ -0,0 +1,73 @@
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Interactive work (the user is waiting on it) is always taken before background work
+enum class TaskPriority {
+    Interactive = 0,
+    Background = 1
+};
+
+// Process-wide work-stealing pool. Every worker owns a deque per priority lane: it pops
+// its own newest task first and steals the oldest task from other workers when idle.
+// Tasks are meant to be small (one table, one folder), so uneven costs balance out.
+class ThreadPool {
+public:
+    using Task = std::function<void()>;
+
+    // Shared pool sized to the hardware concurrency
+    static ThreadPool& instance();
+
+    explicit ThreadPool(size_t threadCount);
+    ~ThreadPool();
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    // Queues a task; from a worker thread it goes to that worker's own deque
+    // task: Work to run
+    // priority: Lane the task is queued in
+    void submit(Task task, TaskPriority priority = TaskPriority::Background);
+
+    // Runs fn(0) .. fn(count - 1) and waits for all of them. Indices are claimed one at a time
+    // by the calling thread and by up to size() helper tasks queued in the pool, so uneven costs
+    // still balance out. The caller only ever runs indices of its own batch, never unrelated
+    // queued work, and sleeps until the indices claimed elsewhere are done. Every claimed index
+    // is running somewhere, so nested calls cannot deadlock.
+    // count: Number of tasks
+    // fn: Task body, called once per index
+    // priority: Lane the tasks are queued in
+    void parallelFor(size_t count, const std::function<void(size_t)>& fn, TaskPriority priority = TaskPriority::Background);
+
+    size_t size() const { return workers.size(); }
+
+private:
+    struct Queue {
+        std::mutex mutex;
+        std::deque<Task> lanes[2]; // Indexed by TaskPriority
+    };
+
+    // Takes the next task for the given worker (or any task for other threads), highest lane first
+    // self: Worker index, or size() when called from outside the pool
+    bool tryPop(size_t self, Task& task);
+
+    void workerLoop(size_t index);
+
+    std::vector<std::unique_ptr<Queue>> queues;
+    std::vector<std::thread> workers;
+    std::atomic<size_t> nextQueue{0}; // Round-robin target for tasks submitted from outside
+    std::atomic<size_t> pending{0};   // Tasks queued but not yet taken
+    std::atomic<bool> stopping{false};
+    std::mutex sleepMutex;
+    std::condition_variable wake;
+};
+
+#endif // THREAD_POOL_H
\ No newline at end of file